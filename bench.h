@@ -0,0 +1,39 @@
+#ifndef PROJECTS_BENCH_H
+#define PROJECTS_BENCH_H
+
+// Timing and random input shared by the `bench.c` of each project. Meant to be
+// included by exactly one translation unit, like the `.c` files it sits with.
+
+#include <time.h> // timespec_get
+
+#include "projects.h"
+
+// Deterministic, so that every variant being compared sees the exact same
+// input, and so that runs can be compared with each other.
+#define BENCH_RNG_SEED  0x9e3779b97f4a7c15u
+
+static u64
+bench_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return cast(u64)ts.tv_sec * 1000000000u + cast(u64)ts.tv_nsec;
+}
+
+// Reset it to `BENCH_RNG_SEED` to replay the same sequence.
+static u64
+bench_rng_state = BENCH_RNG_SEED;
+
+static u64
+bench_rng_next(void)
+{
+    // xorshift64
+    u64 x = bench_rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    bench_rng_state = x;
+    return x;
+}
+
+#endif // PROJECTS_BENCH_H
@@ -0,0 +1,367 @@
+// `writev` for utils/rope.c.
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>  // printf, tmpfile
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcmp, memcpy
+
+#include <bench.h>
+#include <mem/allocator.c>
+#include <mem/arena.c>
+#include <mem/growing_arena.c>
+#include <mem/heap.c>
+#include <utils/strings.c>
+#include <utils/intern.c>
+#include <utils/rope.c>
+
+#include "bigint.c"
+#include "lexer.c"
+
+// Size of the generated input, and how many distinct identifiers it uses.
+#define BENCH_INPUT_SIZE    (8 * 1024 * 1024)
+#define BENCH_VOCABULARY    1024
+#define BENCH_PASSES        5
+
+// Names resolved against per identifier, like the variables of a scope.
+#define BENCH_SCOPE_SIZE    32
+
+// Decimal digits of the numbers rendered to ropes. The checks use tiny rope
+// chunks, so that a single `writev` batch cannot hold them all.
+#define BENCH_ROPE_CHECK_DIGITS     20000
+#define BENCH_ROPE_CHECK_CHUNK      ROPE_MIN_CHUNK_SIZE
+#define BENCH_ROPE_DIGITS           (4 * 1024 * 1024)
+
+
+// Checksum of the work done, so that the loops are not optimized away.
+static volatile size_t
+bench_sink;
+
+
+/** @brief Fill `buf` with expressions like `alpha_12 and beta_3 < 42 or
+ *  true`, mostly made of identifiers drawn from a fixed vocabulary. */
+static size_t
+bench_fill_input(char *buf, size_t cap)
+{
+    static const char *const stems[] = {
+        "alpha", "beta", "gamma", "delta", "value", "count", "total", "index",
+    };
+    static const char *const glue[] = {
+        " and ", " or ", " + ", " * ", " < ", " == ", " - ", " and not_",
+    };
+    size_t len = 0;
+
+    for (;;) {
+        char word[64];
+        u64 r = bench_rng_next();
+        int n;
+
+        switch (r % 8) {
+        case 0:  n = snprintf(word, sizeof(word), "%u", cast(uint)(r >> 8) % 1000); break;
+        case 1:  n = snprintf(word, sizeof(word), "%s", (r & 256) ? "true" : "false"); break;
+        default:
+            n = snprintf(word, sizeof(word), "%s_%u", stems[(r >> 8) % count_of(stems)],
+                cast(uint)((r >> 16) % (BENCH_VOCABULARY / count_of(stems))));
+            break;
+        }
+        n += snprintf(word + n, sizeof(word) - cast(size_t)n, "%s",
+            ((r >> 32) % 16 == 0) ? "\n" : glue[(r >> 40) % count_of(glue)]);
+
+        if (len + cast(size_t)n > cap) {
+            return len;
+        }
+        memcpy(buf + len, word, cast(size_t)n);
+        len += cast(size_t)n;
+    }
+}
+
+
+/** @brief Lex all of `input`, resolving each identifier to one of `scope`
+ *  the way each lexer allows: by comparing bytes, or pointers. */
+static void
+bench_lex(const char *name, String input, Intern *intern, const String scope[])
+{
+    const Intern_String *scope_idents[BENCH_SCOPE_SIZE];
+    size_t tokens = 0, matches = 0;
+    u64 start, stop;
+
+    if (intern != NULL) {
+        for (size_t i = 0; i < BENCH_SCOPE_SIZE; i += 1) {
+            scope_idents[i] = intern_get(intern, scope[i]);
+        }
+    }
+
+    start = bench_now_ns();
+    for (int pass = 0; pass < BENCH_PASSES; pass += 1) {
+        Lexer x;
+        Token t;
+
+        lexer_init(&x, input, intern);
+        do {
+            t = lexer_lex(&x);
+            tokens += 1;
+            if (t.type != TOKEN_IDENTIFIER) {
+                continue;
+            }
+
+            for (size_t i = 0; i < BENCH_SCOPE_SIZE; i += 1) {
+                bool found;
+                if (intern != NULL) {
+                    found = (t.ident == scope_idents[i]);
+                } else {
+                    found = (t.lexeme.len == scope[i].len
+                        && memcmp(t.lexeme.data, scope[i].data, scope[i].len) == 0);
+                }
+                if (found) {
+                    matches += 1;
+                    break;
+                }
+            }
+        } while (t.type != TOKEN_EOF);
+    }
+    stop = bench_now_ns();
+    bench_sink = tokens + matches;
+
+    printfln("%-10s %8.1f MiB/s, %6.1f ns/token (%zu resolved)", name,
+        cast(f64)(input.len * BENCH_PASSES) / (1024.0 * 1024.0)
+            / (cast(f64)(stop - start) / 1e9),
+        cast(f64)(stop - start) / cast(f64)tokens,
+        matches / BENCH_PASSES);
+}
+
+// ROPE ==================================================================== {{{
+
+/** @brief Replace `b` with a random `limbs`-digit number, possibly negative.
+ *  Parsing a decimal string instead would take quadratic time. */
+static void
+bench_random_bigint(BigInt *b, size_t limbs)
+{
+    bigint_destroy(b);
+    if (internal_bigint_init_len(b, limbs, heap_allocator()) != BIGINT_OK) {
+        eprintln("Out of memory");
+        exit(1);
+    }
+    for (size_t i = 0; i < limbs; i += 1) {
+        b->data[i] = cast(BigInt_DIGIT)(bench_rng_next() % BIGINT_DIGIT_BASE);
+    }
+    // No leading zeroes.
+    b->data[limbs - 1] = 1 + cast(BigInt_DIGIT)(bench_rng_next() % BIGINT_DIGIT_MAX);
+    b->sign = (bench_rng_next() & 1) ? BIGINT_NEGATIVE : BIGINT_POSITIVE;
+}
+
+
+/** @brief Read all of `stream` from the start into `buf`.
+ *
+ * @return The number of bytes read, up to `cap`.
+ */
+static size_t
+bench_read_back(FILE *stream, char *buf, size_t cap)
+{
+    rewind(stream);
+    return fread(buf, 1, cap, stream);
+}
+
+
+/** @brief Render `src` in `base` to a rope, and check that flattening it and
+ *  writing it to a file after some already buffered text both give exactly
+ *  `bigint_to_base_lstring`, and `expect` too if it is not `NULL`.
+ *
+ * @return `true` if all of them agree.
+ */
+static bool
+bench_check_rope_base(const BigInt *src, int base, const char *expect)
+{
+    static const char preamble[] = "value = ";
+    const char *want;
+    char *got_file = NULL;
+    size_t want_len, got_len;
+    String flat;
+    FILE *stream;
+    Rope r;
+    bool ok;
+
+    want = bigint_to_base_lstring(src, base, &want_len, heap_allocator());
+    rope_init(&r, BENCH_ROPE_CHECK_CHUNK, heap_allocator());
+    if (want == NULL || !bigint_to_base_rope(src, base, &r)) {
+        eprintln("Out of memory");
+        exit(1);
+    }
+
+    // Otherwise a formatting bug shared by both renderers would go unnoticed.
+    if (expect != NULL && (strlen(expect) != want_len || memcmp(want, expect, want_len) != 0)) {
+        printfln("base %i: expected \"%s\", got \"%s\"", base, expect, want);
+        ok = false;
+    } else {
+        ok = true;
+    }
+
+    flat = rope_flatten(&r, heap_allocator());
+    ok   = ok && flat.data != NULL && flat.len == want_len && r.len == want_len
+        && memcmp(flat.data, want, want_len) == 0 && flat.data[flat.len] == '\0';
+
+    stream = tmpfile();
+    if (stream != NULL) {
+        got_file = cast(char *)malloc(sizeof(preamble) + want_len);
+    }
+    if (got_file == NULL) {
+        eprintln("Failed to create a temporary file");
+        exit(1);
+    }
+    fputs(preamble, stream);
+    ok = ok && rope_write_file(&r, stream);
+    got_len = bench_read_back(stream, got_file, sizeof(preamble) + want_len);
+    ok = ok && got_len == sizeof(preamble) - 1 + want_len
+        && memcmp(got_file, preamble, sizeof(preamble) - 1) == 0
+        && memcmp(got_file + sizeof(preamble) - 1, want, want_len) == 0;
+    fclose(stream);
+
+    if (!ok) {
+        printfln("base %i: rope differs from bigint_to_base_lstring (%zu chars)",
+            base, want_len);
+    }
+    free(got_file);
+    mem_free(cast(void *)flat.data, flat.len + 1, heap_allocator());
+    mem_free(cast(void *)want, want_len + 1, heap_allocator());
+    rope_destroy(&r);
+    return ok;
+}
+
+
+/** @brief Check ropes against strings for zero, a small and a big number in
+ *  every base with a prefix, then time writing a huge one to a file both
+ *  ways. */
+static bool
+bench_rope(void)
+{
+    static const int bases[] = {2, 8, 10, 16};
+    // Digits past the most significant one are padded to a whole limb.
+    static const struct {
+        const char *input;
+        const char *expect[count_of(bases)];
+    } fixed[] = {
+        {"0", {"0", "0", "0", "0"}},
+        {"-7", {"-0b111", "-0o7", "-7", "-0x7"}},
+        {"1000000000", {
+            "0b1000000000000000000000000000000",
+            "0o10000000000",
+            "1000000000",
+            "0x100000000"}},
+        {"-999999999999999999", {
+            "-0b111011100110101100100111111111111011100110101100100111111111",
+            "-0o73465447777346544777",
+            "-999999999999999999",
+            "-0x3b9ac9ff3b9ac9ff"}},
+    };
+    BigInt b;
+    bool ok = true;
+
+#if defined(UTILS_ROPE_WRITEV)
+    println("rope: writing files with writev");
+#else // !UTILS_ROPE_WRITEV
+    println("rope: writing files with fwrite");
+#endif // UTILS_ROPE_WRITEV
+
+    bigint_init(&b, heap_allocator());
+    for (size_t i = 0; i <= count_of(fixed); i += 1) {
+        bool is_fixed = i < count_of(fixed);
+
+        if (!is_fixed) {
+            bench_random_bigint(&b, BENCH_ROPE_CHECK_DIGITS / BIGINT_DIGIT_BASE10_LENGTH);
+        } else {
+            // Setting accumulates into the old value otherwise.
+            bigint_clear(&b);
+            if (bigint_set_base_lstring(&b, fixed[i].input, strlen(fixed[i].input), 10) != BIGINT_OK) {
+                eprintln("Out of memory");
+                exit(1);
+            }
+        }
+        for (size_t j = 0; j < count_of(bases); j += 1) {
+            const char *expect = is_fixed ? fixed[i].expect[j] : NULL;
+            ok = bench_check_rope_base(&b, bases[j], expect) && ok;
+        }
+    }
+    if (!ok) {
+        bigint_destroy(&b);
+        return false;
+    }
+    println("rope: matches bigint_to_base_lstring and the expected strings in "
+        "bases 2, 8, 10 and 16, flattened and written to a file");
+
+    // Both write the same text to a scratch file, so only the rendering and
+    // writing differ.
+    bench_random_bigint(&b, BENCH_ROPE_DIGITS / BIGINT_DIGIT_BASE10_LENGTH);
+    for (int pass = 0; pass < 2; pass += 1) {
+        FILE *stream = tmpfile();
+        const char *str;
+        size_t len = 0;
+        u64 start, stop;
+        Rope r;
+
+        if (stream == NULL) {
+            eprintln("Failed to create a temporary file");
+            exit(1);
+        }
+        start = bench_now_ns();
+        if (pass == 0) {
+            str = bigint_to_lstring(&b, &len, heap_allocator());
+            ok  = str != NULL && fwrite(str, 1, len, stream) == len && fflush(stream) == 0;
+            mem_free(cast(void *)str, len + 1, heap_allocator());
+        } else {
+            rope_init(&r, 0, heap_allocator());
+            ok  = bigint_to_rope(&b, &r) && rope_write_file(&r, stream);
+            len = r.len;
+            rope_destroy(&r);
+        }
+        stop = bench_now_ns();
+        fclose(stream);
+        if (!ok) {
+            eprintln("Failed to write the temporary file");
+            exit(1);
+        }
+        printfln("%-10s %zu digits to a file in %.2f ms",
+            (pass == 0) ? "string" : "rope", len, cast(f64)(stop - start) / 1e6);
+    }
+    bigint_destroy(&b);
+    return true;
+}
+
+// === }}} =====================================================================
+
+int
+main(void)
+{
+    static char names[BENCH_SCOPE_SIZE][16];
+    String scope[BENCH_SCOPE_SIZE];
+    char *buf = cast(char *)malloc(BENCH_INPUT_SIZE);
+    String input;
+    Intern intern;
+
+    // Common prefixes make byte comparisons work for their answer.
+    for (size_t i = 0; i < BENCH_SCOPE_SIZE; i += 1) {
+        int n = snprintf(names[i], sizeof(names[i]), "value_%zu", i);
+        scope[i].data = names[i];
+        scope[i].len  = cast(size_t)n;
+    }
+
+    if (buf == NULL) {
+        eprintln("Out of memory");
+        return 1;
+    }
+    input.data = buf;
+    input.len  = bench_fill_input(buf, BENCH_INPUT_SIZE);
+
+    bench_lex("bytes", input, NULL, scope);
+
+    intern_init(&intern, heap_allocator());
+    if (!lexer_intern_keywords(&intern)) {
+        eprintln("Out of memory");
+        return 1;
+    }
+    // The lexer only looks identifiers up, so only the keywords and the scope
+    // are ever interned.
+    bench_lex("interned", input, &intern, scope);
+    printfln("%zu strings interned", intern.count);
+    intern_destroy(&intern);
+
+    free(buf);
+    return bench_rope() ? 0 : 1;
+}
@@ -15,10 +15,11 @@ bigint_init(BigInt *b, Allocator allocator)
     b->sign      = BIGINT_POSITIVE;
 }
 
+/** @note `b->data` is left uninitialized; callers must write `b->data[:len]`. */
 static BigInt_Error
 internal_bigint_init_len_cap(BigInt *b, size_t len, size_t cap, Allocator allocator)
 {
-    b->data = array_make(BigInt_DIGIT, cap, allocator);
+    b->data = array_make_non_zeroed(BigInt_DIGIT, cap, allocator);
     if (b->data == NULL) {
         return BIGINT_ERROR_MEMORY;
     }
@@ -153,17 +154,8 @@ internal_string_trim(String *s)
 static BigInt_DIGIT
 internal_char_to_digit(char ch, int base)
 {
-    BigInt_DIGIT i = BIGINT_DIGIT_MAX;
-    // Convert character to potential integer representation up to base-36
-    if (char_is_digit(ch)) {
-        i = cast(BigInt_DIGIT)(ch - '0');
-    } else if (char_is_lower(ch)) {
-        i = cast(BigInt_DIGIT)(ch - 'a' + 10);
-    } else if (char_is_upper(ch)) {
-        i = cast(BigInt_DIGIT)(ch - 'A' + 10);
-    }
-
-    // Ensure above conversion is valid
+    // Non-digits map to `ASCII_DIGIT_INVALID`, which is never a valid digit.
+    BigInt_DIGIT i = ascii_digit_value(ch);
     if (i < cast(BigInt_DIGIT)base) {
         return i;
     }
@@ -212,14 +204,17 @@ bigint_clear(BigInt *b)
     b->len  = 0;
 }
 
+/** @note Digits past the old length are left uninitialized; callers must
+ *  write all of `b->data[old_len:n]`. */
 static bool
-internal_bigint_resize(BigInt *b, size_t n)
+internal_bigint_resize_loc(BigInt *b, size_t n, const char *location)
 {
     if (n > b->cap) {
         BigInt_DIGIT *ptr;
 
         // Don't free `b->data` because the outermost caller still owns it.
-        ptr = array_resize(BigInt_DIGIT, b->data, b->cap, n, b->allocator);
+        ptr = array_resize_non_zeroed_loc(BigInt_DIGIT, b->data, b->cap, n,
+            b->allocator, location);
         if (ptr == NULL) {
             return false;
         }
@@ -231,6 +226,10 @@ internal_bigint_resize(BigInt *b, size_t n)
     return true;
 }
 
+// Attribute growth to the operation that needs it, e.g. `bigint_add`.
+#define internal_bigint_resize(b, n)                                           \
+    internal_bigint_resize_loc(b, n, FILE_LINE_STRING)
+
 BigInt_Error
 bigint_copy(BigInt *dst, const BigInt *src)
 {
@@ -337,21 +336,6 @@ fail:
 
 }
 
-/** @brief Gets the place-value of the MSD of `d`, e.g. 1234 returns 1000. */
-static BigInt_DIGIT
-internal_digit_place_value(BigInt_DIGIT d, int base)
-{
-    // Use Result type in case of Digit overflow.
-    BigInt_WORD place = 1;
-
-    // Check the next place value; may be the one we are looking for.
-    // E.g. 9 returns 1 but 10 returns 10.
-    while (place * cast(BigInt_WORD)base <= cast(BigInt_WORD)d) {
-        place *= cast(BigInt_WORD)base;
-    }
-    return cast(BigInt_DIGIT)place;
-}
-
 /** @brief Get the maximum number of base-`base` digits that would fit in a
  * base-`DIGIT_BASE` number. */
 static int
@@ -406,100 +390,93 @@ bigint_string_length(const BigInt *src)
 }
 
 
-/** @brief Writes all significant digits from MSD to LSD. */
-static bool
-internal_string_append_digit(String_Builder *sb, BigInt_DIGIT digit, int base)
-{
-    BigInt_DIGIT pv = internal_digit_place_value(digit, base);
-    // Have digits to process and won't divide by zero?
-    while (pv > 0) {
-        // Get the leftmost digit (MSD), e.g. 1 in 1234.
-        BigInt_DIGIT msd = digit / pv;
-        if (!string_write_char(sb, cast(char)msd + '0')) {
-            return false;
-        }
-
-        // "Trim" the MSD's magnitude, e.g. remove 1000 from 1234.
-        digit -= msd * pv;
-        pv /= cast(BigInt_DIGIT)base;
-    }
-    return true;
-}
-
-static bool
-internal_string_append_base_prefix(String_Builder *sb, int base)
-{
-    switch (base) {
-    case 2:
-        if (!string_write_char(sb, '0')) return false;
-        if (!string_write_char(sb, 'b')) return false;
-        break;
-    case 8:
-        if (!string_write_char(sb, '0')) return false;
-        if (!string_write_char(sb, 'o')) return false;
-        break;
-    case 16:
-        if (!string_write_char(sb, '0')) return false;
-        if (!string_write_char(sb, 'x')) return false;
-        break;
-    }
-    return true;
-}
-
 const char *
 bigint_to_base_lstring(const BigInt *src, int base, size_t *len, Allocator allocator)
 {
     String_Builder sb;
+    size_t width;
+
+    // The length is known up front, so size the buffer (and its nul
+    // terminator) exactly once.
     string_builder_init(&sb, allocator);
+    if (!string_builder_reserve(&sb, bigint_base_string_length(src, base) + 1)) {
+        return NULL;
+    }
 
     // No digits to work with?
     if (bigint_is_zero(src)) {
-        if (!string_write_char(&sb, '0')) {
-            goto fail;
-        }
-        goto nul_terminate;
+        string_write_char(&sb, '0');
+        return string_to_cstring(&sb, len);
     }
 
     if (bigint_is_neg(src)) {
-        if (!string_write_char(&sb, '-')) {
-            goto fail;
-        }
+        string_write_char(&sb, '-');
     }
 
-    if (!internal_string_append_base_prefix(&sb, base)) {
-        goto fail;
+    // Binary, octal and hexadecimal have widely-used base prefixes
+    switch (base) {
+    case 2:  string_write_literal(&sb, "0b"); break;
+    case 8:  string_write_literal(&sb, "0o"); break;
+    case 16: string_write_literal(&sb, "0x"); break;
     }
 
     // Write the MSD. It will never have leading zeroes.
     size_t msd_index = src->len - 1;
-    if (!internal_string_append_digit(&sb, src->data[msd_index], base)) {
-        goto fail;
+    string_write_uint(&sb, src->data[msd_index], cast(uint)base, /*min_digits=*/0);
+
+    // Write everything past the MSD, padded to a fixed width, e.g. in
+    // base-100, we want to pad '1' with 1 zero to get 01 in 1801.
+    width = cast(size_t)internal_digit_length_in_base(base);
+    for (size_t i = msd_index; i > 0; i -= 1) {
+        string_write_uint(&sb, src->data[i - 1], cast(uint)base, width);
+    }
+    return string_to_cstring(&sb, len);
+}
+
+bool
+bigint_to_base_rope(const BigInt *src, int base, Rope *r)
+{
+    const char *prefix = NULL;
+    size_t width;
+
+    if (bigint_is_zero(src)) {
+        return rope_write_char(r, '0');
+    }
+
+    if (bigint_is_neg(src) && !rope_write_char(r, '-')) {
+        return false;
+    }
+
+    switch (base) {
+    case 2:  prefix = "0b"; break;
+    case 8:  prefix = "0o"; break;
+    case 16: prefix = "0x"; break;
+    }
+    if (prefix != NULL && !rope_write_string(r, prefix, 2)) {
+        return false;
     }
 
-    // Write everything past the MSD. They may have leading zeroes.
+    // Same layout as `bigint_to_base_lstring`, but no digit is ever moved
+    // once written.
+    size_t msd_index = src->len - 1;
+    if (!rope_write_uint(r, src->data[msd_index], cast(uint)base, /*min_digits=*/0)) {
+        return false;
+    }
+
+    width = cast(size_t)internal_digit_length_in_base(base);
     for (size_t i = msd_index; i > 0; i -= 1) {
-        BigInt_DIGIT digit = src->data[i - 1];
-
-        // For each digit, write its base-10 representation from most-to-least
-        // significant using the current maximum place value (`10**n`).
-        BigInt_WORD tmp = cast(BigInt_WORD)digit;
-        // E.g. in base-100, we want to pad '1' with 1 zero to get 01 in 1801.
-        while (tmp * cast(BigInt_WORD)base < BIGINT_DIGIT_BASE) {
-            if (!string_write_char(&sb, '0')) {
-                goto fail;
-            }
-            tmp *= cast(BigInt_WORD)base;
-        }
-        if (!internal_string_append_digit(&sb, digit, base)) {
-            goto fail;
+        if (!rope_write_uint(r, src->data[i - 1], cast(uint)base, width)) {
+            return false;
         }
     }
+    return true;
+}
 
-nul_terminate:
-    return string_to_cstring(&sb, len);
-
-fail:
-    return NULL;
+bool
+bigint_to_rope(const BigInt *src, Rope *r)
+{
+    int base = 10;
+    return bigint_to_base_rope(src, base, r);
 }
 
 const char *
@@ -723,6 +700,12 @@ bigint_mul(BigInt *dst, const BigInt *a, const BigInt *b)
     max_used = a->len;
     min_used = b->len;
 
+    // 0 * a == 0; there would be no rows to initialize `tmp` with.
+    if (min_used == 0) {
+        bigint_clear(dst);
+        return BIGINT_OK;
+    }
+
     err = internal_bigint_init_len(&tmp, max_used + min_used, dst->allocator);
     if (err) return err;
 
@@ -733,16 +716,25 @@ bigint_mul(BigInt *dst, const BigInt *a, const BigInt *b)
     tmp.sign = (a->sign == b->sign) ? BIGINT_POSITIVE : BIGINT_NEGATIVE;
 
     // long multiplication
+    //
+    // Row `b_i` writes `tmp.data[b_i:b_i + max_used + 1]`. All but the last
+    // of those digits were already written by the previous rows, so only the
+    // first row has nothing to accumulate into. This is why `tmp` need not
+    // be zeroed beforehand.
     for (size_t b_i = 0; b_i < min_used; b_i += 1) {
         BigInt_WORD mult, carry = 0;
 
         mult = cast(BigInt_WORD)b->data[b_i];
         for (size_t a_i = 0; a_i < max_used; a_i += 1) {
+            // (base - 1)**2 + 2*(base - 1) == base**2 - 1 always fits.
             BigInt_WORD prod = mult * cast(BigInt_WORD)a->data[a_i] + carry;
+            if (b_i > 0) {
+                prod += cast(BigInt_WORD)tmp.data[b_i + a_i];
+            }
             carry = prod / BIGINT_DIGIT_BASE;
-            tmp.data[b_i + a_i] += cast(BigInt_DIGIT)(prod % BIGINT_DIGIT_BASE);
+            tmp.data[b_i + a_i] = cast(BigInt_DIGIT)(prod % BIGINT_DIGIT_BASE);
         }
-        tmp.data[b_i + max_used] += carry;
+        tmp.data[b_i + max_used] = cast(BigInt_DIGIT)carry;
     }
     internal_bigint_swap(&tmp, dst);
     bigint_destroy(&tmp);
@@ -793,6 +785,12 @@ internal_bigint_add_digit_unsigned(BigInt *dst, const BigInt *a, BigInt_DIGIT b)
 
         dst->data[i] = sum;
         if (carry == 0) {
+            // Remaining digits are unchanged; only copy them if not aliasing.
+            if (dst != a) {
+                for (i += 1; i < used; i += 1) {
+                    dst->data[i] = a->data[i];
+                }
+            }
             break;
         }
     }
@@ -821,6 +819,12 @@ internal_bigint_sub_digit_unsigned(BigInt *dst, const BigInt *a, BigInt_DIGIT b)
         }
         dst->data[i] = cast(BigInt_DIGIT)diff;
         if (borrow == 0) {
+            // Remaining digits are unchanged; only copy them if not aliasing.
+            if (dst != a) {
+                for (i += 1; i < used; i += 1) {
+                    dst->data[i] = a->data[i];
+                }
+            }
             break;
         }
     }
@@ -890,8 +894,12 @@ bigint_sub_digit(BigInt *dst, const BigInt *a, BigInt_DIGIT b)
     //    and a >= 0
     //    and b >= 0
     if (bigint_lt_digit_abs(a, b)) {
-        internal_bigint_resize(dst, a->len + 1);
-        BigInt_WORD diff = b - a->data[0];
+        // `|a| < b` so `a` has at most 1 digit, and so does the result.
+        BigInt_DIGIT a_digit = bigint_is_zero(a) ? 0 : a->data[0];
+        if (!internal_bigint_resize(dst, 1)) {
+            return BIGINT_ERROR_MEMORY;
+        }
+        BigInt_WORD diff = b - a_digit;
         dst->data[0] = cast(BigInt_DIGIT)diff;
         bigint_neg(dst, dst);
         return internal_bigint_clamp(dst);
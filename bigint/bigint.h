@@ -2,6 +2,7 @@
 #define BIGINT_H
 
 #include <mem/allocator.h>
+#include <utils/rope.h>
 
 // === CONFIGUATION ======================================================== {{{
 
@@ -158,6 +159,22 @@ const char *
 bigint_to_base_lstring(const BigInt *src, int base, size_t *len, Allocator allocator);
 
 
+/** @brief Append the base-N representation of `src` to `r`, with the same
+ *  format as `bigint_to_base_lstring`. Unlike it, never needs a buffer for
+ *  the whole string, so it suits numbers with millions of digits.
+ *
+ * @return `false` if out of memory, after which `r` holds a prefix of the
+ *  string.
+ */
+bool
+bigint_to_base_rope(const BigInt *src, int base, Rope *r);
+
+
+/** @brief Append the base-10 representation of `src` to `r`. */
+bool
+bigint_to_rope(const BigInt *src, Rope *r);
+
+
 /** @brief Write the base-`base` representation of `src`. */
 const char *
 bigint_to_base_string(const BigInt *src, int base, Allocator allocator);
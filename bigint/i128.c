@@ -144,7 +144,7 @@ u128_from_string(const char *restrict s, size_t n, const char **restrict end_ptr
     }
 
     for (; i < n; i += 1) {
-        u64 digit = 0;
+        u64 digit;
         char ch;
 
         ch = s[i];
@@ -152,17 +152,9 @@ u128_from_string(const char *restrict s, size_t n, const char **restrict end_ptr
             continue;
         }
 
-        if (char_is_digit(ch)) {
-            digit = cast(u64)(ch - '0');
-        } else if (char_is_upper(ch)) {
-            digit = cast(u64)(ch - 'A' + 10);
-        } else if (char_is_lower(ch)) {
-            digit = cast(u64)(ch - 'a' + 10);
-        } else {
-            break;
-        }
-
-        // Not a valid digit in this base?
+        // Not a valid digit in this base? Non-digits map to
+        // `ASCII_DIGIT_INVALID`, which never is.
+        digit = ascii_digit_value(ch);
         if (digit >= cast(u64)base) {
             break;
         }
@@ -441,102 +433,6 @@ u128_sub(u128 a, u128 b)
 }
 
 
-/** @link catid on stackoverflow: https://stackoverflow.com/a/51587262 */
-static u128
-internal_u64_mul_u64(u64 a, u64 b)
-{
-    u128 dst;
-    u64 a0, a1, b0, b1, p00, p10, p01, p11, mid;
-    const u64 mask = UINT32_MAX;
-
-    // 64x64 multiplication results in 128-bit results. We simulate it by
-    // chopping it into multiple 32x32 multiplications with 64-bit results.
-    a0 =  a        & mask; // a[00:32]
-    a1 = (a >> 32) & mask; // a[32:64]
-    b0 =  b        & mask; // b[00:32]
-    b1 = (b >> 32) & mask; // b[32:64]
-
-    // 32x32 products sans place values.
-    //
-    // +----------------+---------------+---------------+---------------+
-    // |   dst[128.................64]  |  dst[64...................0]  |
-    // |   hi[64...00]  |  hi[32...00]  |  lo[64...32]  |  lo[32...00]  |
-    // +----------------+---------------+---------------+---------------+
-    // |                |               |           a1  |           a0  |
-    // | *              |               |           b1  |           b0  |
-    // +----------------+---------------+---------------+---------------+
-    // | =              |               |               |  p00 = a0*b0  |
-    // | +              |               |  p10 = a1*b0  |               |
-    // | +              |               |  p01 = a0*b1  |               |
-    // | +              |  p11 = a1*b1  |               |               |
-    // +----------------+---------------+---------------+---------------+
-    // | =              |               |  p00[64..32]  |  p00[32..00]  |
-    // | +              |  p10[64..32]  |  p10[32..00]  |               |
-    // | +              |  p01[64..32]  |  p01[32..00]  |               |
-    // | + p11[64..32]  |  p11[32..00]  |               |               |
-    // +----------------+---------------+---------------+---------------+
-    p00 = a0 * b0;
-    p10 = a1 * b0;
-    p01 = a0 * b1;
-    p11 = a1 * b1;
-
-    // Calculate part of 64x32 96-bit product `a * b0` that is to be
-    // part of dst[64...00].
-    //  = (a1 * b0) * (2**32)**1
-    //  + (a0 * b0) * (2**32)**0
-    //
-    // The 64x32 product goes into dst[96..00].
-    // It is split between dst.lo[64..00] and dst.hi[32..00].
-    //
-    //  p10[64..00] - Overlaps both intermediates, never overflows.
-    //  p01[32..00] - Overlaps the dst[64..00].
-    //  p00[64..32] - Only the upper half overlaps the 96-bit product.
-    //
-    // Concept check: (using `digits.py`)
-    // ```py
-    // bits = 32
-    // mask = int_max(u32) # 0b11111111111111111111111111111111
-    // a0 = mask
-    // a1 = mask
-    // b0 = mask
-    // b1 = mask
-    //
-    // p00 = a0 * b0
-    // p10 = a1 * b0
-    // p01 = a0 * b1
-    // mid = p10 + (p01 & mask) + (p00 >> bits)
-    //
-    // print(int_bin(p10, min_groups=2, group_size=32))
-    // # '0b11111111111111111111111111111110_00000000000000000000000000000001'
-    //
-    // print(int_bin(p01 & mask, min_groups=2, group_size=32))
-    // # '0b00000000000000000000000000000000_00000000000000000000000000000001'
-    //
-    // print(int_bin(p00 >> bits, min_groups=2, group_size=32))
-    // # '0b00000000000000000000000000000000_11111111111111111111111111111110'
-    //
-    // print(int_bin(mid, min_groups=2, group_size=32))
-    // # '0b11111111111111111111111111111111_00000000000000000000000000000000'
-    // ```
-    mid = p10 + (p01 & mask) + (p00 >> 32);
-
-    // Lower 64-bits of the 64x64 128-bit product is in dst[64..00].
-    //
-    //  mid[32..00] - 96-bit product a*b0 that goes in dst[64..32].
-    //  p00[32..00] - p00[32:64] was already added to `mids`.
-    dst.lo = (mid << 32) | (p00 & mask);
-
-    // Upper 64 bits of the 64x64 128-bit product is in dst[128..64].
-    // We know that 64x64 multiplication cannot possibly overflow
-    // the 128-bits hence we do not check for it.
-    //
-    //  p11[64..00] - Goes into dst[128..64].
-    //  mid[64..32] - 96-bit product a*b0 that goes in dst[96..64].
-    //  p01[64..32] - The portion that goes in dst[96..64].
-    dst.hi = p11 + (mid >> 32) + (p01 >> 32);
-    return dst;
-}
-
 u128
 u128_mul(u128 a, u128 b)
 {
@@ -610,7 +506,7 @@ u128_mul_u64(u128 a, u64 b)
     a1 = a.hi;
 
     // No `b1`, meaning no `a0 * b1`, so we can save a few instructions.
-    dst     = internal_u64_mul_u64(a0, b0);
+    dst.lo  = u64_mul_wide(a0, b0, &dst.hi);
     p10     = a1 * b0;
     dst.hi += p10;
     return dst;
@@ -704,7 +600,7 @@ u128_checked_mul(u128 *dst, u128 a, u128 b)
     b0 = b.lo;
     b1 = b.hi;
 
-    *dst = internal_u64_mul_u64(a0, b0);
+    dst->lo = u64_mul_wide(a0, b0, &dst->hi);
 
     // Overflow check for upper 64 bits:
     //
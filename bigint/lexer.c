@@ -1,11 +1,25 @@
 #include "lexer.h"
 
+bool
+lexer_intern_keywords(Intern *intern)
+{
+    for (Token_Type t = TOKEN_AND; t <= TOKEN_TRUE; t += 1) {
+        Intern_String *keyword = intern_get(intern, TOKEN_STRINGS[t]);
+        if (keyword == NULL) {
+            return false;
+        }
+        keyword->tag = cast(int)t;
+    }
+    return true;
+}
+
 void
-lexer_init(Lexer *x, String input)
+lexer_init(Lexer *x, String input, const Intern *intern)
 {
     x->input  = input;
     x->start  = 0;
     x->cursor = 0;
+    x->intern = intern;
 }
 
 static bool
@@ -63,6 +77,7 @@ lexer_make_token(Lexer *x, Token_Type t)
     Token k;
     k.type   = t;
     k.lexeme = string_slice(x->input, x->start, x->cursor);
+    k.ident  = NULL;
     return k;
 }
 
@@ -85,18 +100,22 @@ lexer_check_keyword_or_identifier(String s)
         if (s.data[0] == 'o' && s.data[1] == 'r') {
             return TOKEN_OR;
         }
+        break;
     case 3:
         if (s.data[0] == 'a' && s.data[1] == 'n' && s.data[2] == 'd') {
             return TOKEN_AND;
         }
+        break;
     case 4:
         if (s.data[0] == 't' && s.data[1] == 'r' && s.data[2] == 'u' && s.data[3] == 'e') {
             return TOKEN_TRUE;
         }
+        break;
     case 5:
         if (s.data[0] == 'f' && s.data[1] == 'a' && s.data[2] == 'l' && s.data[3] == 's' && s.data[4] == 'e') {
             return TOKEN_FALSE;
         }
+        break;
     default:
         break;
     }
@@ -116,8 +135,20 @@ lexer_make_keyword_or_identifier(Lexer *x)
         ch = lexer_peek(x);
     }
     s        = string_slice(x->input, /*start=*/x->start, /*stop=*/x->cursor);
-    t.type   = lexer_check_keyword_or_identifier(s);
     t.lexeme = s;
+    t.ident  = NULL;
+
+    // Keywords were interned by `lexer_intern_keywords`, so their tag already
+    // says which one they are, and anything not in the table is an identifier.
+    // Only look up, so that the table does not grow with every new name.
+    // Without a table, compare bytes.
+    if (x->intern != NULL) {
+        t.ident = intern_find(x->intern, s);
+        t.type  = (t.ident != NULL && t.ident->tag != 0)
+            ? cast(Token_Type)t.ident->tag : TOKEN_IDENTIFIER;
+    } else {
+        t.type = lexer_check_keyword_or_identifier(s);
+    }
     return t;
 }
 
@@ -174,6 +205,7 @@ lexer_lex(Lexer *x)
         } else {
             t = TOKEN_GREATER_THAN;
         }
+        break;
     case '!':
         if (lexer_match(x, '=')) {
             t = TOKEN_NOT_EQUAL;
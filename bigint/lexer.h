@@ -4,7 +4,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 
-#include <utils/strings.h>
+#include <utils/intern.h>
 
 enum Token_Type {
     TOKEN_UNKNOWN,
@@ -48,6 +48,11 @@ typedef struct Token Token;
 struct Token {
     Token_Type type;
     String lexeme;
+
+    // The interned `lexeme` of keywords and of identifiers that were already
+    // in the lexer's intern table, e.g. put there by the caller. `NULL`
+    // otherwise.
+    const Intern_String *ident;
 };
 
 typedef struct Lexer Lexer;
@@ -55,10 +60,22 @@ struct Lexer {
     String input;
     size_t start;
     size_t cursor;
+
+    // If not `NULL`, identifiers are looked up here, but never added, and
+    // keywords are told apart by their tag rather than by their bytes.
+    const Intern *intern;
 };
 
+
+/** @brief Tag the keywords in `intern` with their token types. Must be
+ *  called on a table before it is given to `lexer_init`. */
+bool
+lexer_intern_keywords(Intern *intern);
+
+
+/** @param intern  May be `NULL`. */
 void
-lexer_init(Lexer *x, String input);
+lexer_init(Lexer *x, String input, const Intern *intern);
 
 Token
 lexer_lex(Lexer *x);
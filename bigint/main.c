@@ -1,27 +1,25 @@
 // C
 #include <stdio.h>  // fprintf
 #include <stdlib.h> // atoi
-#include <string.h> // strlen
+#include <string.h> // memcpy, strcspn
 
 // main
 #include <mem/arena.c>
+#include <mem/growing_arena.c>
+#include <mem/heap.c>
 #include "parser.c"
+#include <utils/utf8.c>
 
-static void
-internal_string_builder_reverse(String_Builder *sb, size_t start, size_t stop)
-{
-    char *buf;
-    size_t left, right;
-
-    buf   = sb->data;
-    left  = start;
-    right = stop - 1;
-    for (; left < right; left++, right--) {
-        char tmp   = buf[left];
-        buf[left]  = buf[right];
-        buf[right] = tmp;
-    }
-}
+// Define to print per-call-site allocation statistics on exit.
+#ifdef BIGINT_TRACK_ALLOCATIONS
+#include <mem/tracking.c>
+#endif // BIGINT_TRACK_ALLOCATIONS
+
+// Define to the path of a file to record every allocation to, for replaying
+// with `mem/bench`.
+#ifdef BIGINT_TRACE_ALLOCATIONS
+#include <mem/trace.c>
+#endif // BIGINT_TRACE_ALLOCATIONS
 
 static char
 internal_int_to_char(int digit)
@@ -34,99 +32,89 @@ internal_int_to_char(int digit)
 }
 
 
-/** @brief Writes at most `len - 2` characters (i.e. `buf[:len - 1]`),
- *  writing the nul character at `len - 1`. */
+/** @brief Write the two's complement bits of `a` in `base`, with a prefix,
+ *  digits separated by `_` into groups, and the last group padded. */
 static const char *
 i128_to_binary_string(i128 a, uint base, uint shift, Allocator allocator)
 {
     String_Builder sb;
-    u128 a_abs, mask;
-    size_t group_size, group_iter, group_total, group_count = 0, prefix_i = 0;
-    char leader_char;
+    u128 bits, mask;
+    size_t group_size, group_total, group_count, digit_count, padded_count, len;
+    const char *prefix;
+    char leader_char, *out;
 
     string_builder_init(&sb, allocator);
-    a_abs = u128_from_i128(a);
-    mask  = u128_from_u64(base - 1);
+    bits = u128_from_i128(a);
+    mask = u128_from_u64(base - 1);
     leader_char = internal_int_to_char(i128_sign(a) ? cast(int)base - 1 : 0);
 
-    // Write base prefix.
     switch (base) {
     case 2:
         // group_size=64 * shift=1 * group_total=2 = 128
         // group_size=32 * shift=1 * group_total=4 = 128
         // group_size=16 * shift=1 * group_total=8 = 128
         // group_size=8  * shift=1 * group_total=8 = 128
+        prefix      = "0b";
         group_size  = 64;
         group_total = 2;
-        if (!string_write_literal(&sb, "0b")) {
-            goto nul_terminate;
-        }
         break;
     case 8:
         // group_size=21 * shift=3 * group_total=2 == 128
         // group_size=10 * shift=3 * group_total=4 == 128
+        prefix      = "0o";
         group_size  = 21;
         group_total = 2;
-        if (!string_write_literal(&sb, "0o")) {
-            goto nul_terminate;
-        }
         break;
     case 16:
         // group_size=16 * shift=4 * group_total=2 == 128
         // group_size=8  * shift=4 * group_total=4 == 128
+        prefix      = "0x";
         group_size  = 8;
         group_total = 4;
-        if (!string_write_literal(&sb, "0x")) {
-            goto nul_terminate;
-        }
         break;
+    default:
+        unreachable();
     }
-    group_iter = group_size;
 
-    prefix_i = sb.len;
-    if (u128_eq(a_abs, U128_ZERO)) {
-        string_write_char(&sb, '0');
-        goto add_leading_zeroes;
+    // Zero still has one digit.
+    digit_count = 1;
+    for (u128 rest = u128_shift_right(bits, shift); !u128_eq(rest, U128_ZERO);
+        rest = u128_shift_right(rest, shift))
+    {
+        digit_count += 1;
     }
 
-    // Write LSD to MSD into the buffer.
-    while (!u128_eq(a_abs, U128_ZERO)) {
-        int digit;
-        char ch;
-
-        // digit = a % base
-        // a     = a / base
-        digit = cast(int)u128_and(a_abs, mask).lo;
-        a_abs = u128_shift_right(a_abs, shift);
-        ch    = internal_int_to_char(digit);
+    // Pad the last group unless it overflows `group_total`, e.g. the top
+    // 2 bits in octal.
+    group_count  = (digit_count + group_size - 1) / group_size;
+    padded_count = digit_count;
+    if (group_count <= group_total) {
+        padded_count = group_count * group_size;
+    }
 
-        if (group_iter == 0) {
-            if (!string_write_char(&sb, '_')) {
-                goto nul_terminate;
-            }
-            group_iter   = group_size;
-            group_count += 1;
+    // Size the buffer exactly once, nul terminator included, so that the
+    // digits can be written right to left without any bounds checks.
+    len = 2 + padded_count + (group_count - 1);
+    if (!string_builder_reserve(&sb, len + 1)) {
+        return NULL;
+    }
+    out = string_builder_extend(&sb, len);
+    out[0] = prefix[0];
+    out[1] = prefix[1];
+    for (size_t i = 0; i < padded_count; i += 1) {
+        if (i > 0 && i % group_size == 0) {
+            out[--len] = '_';
         }
-        group_iter -= 1;
 
-        if (!string_write_char(&sb, ch)) {
-            goto nul_terminate;
+        if (i < digit_count) {
+            // digit = a % base
+            // a     = a / base
+            out[--len] = internal_int_to_char(cast(int)u128_and(bits, mask).lo);
+            bits       = u128_shift_right(bits, shift);
+        } else {
+            out[--len] = leader_char;
         }
     }
-
-add_leading_zeroes:
-    if (group_count < group_total) {
-        while (group_iter > 0) {
-            if (!string_write_char(&sb, leader_char)) {
-                goto nul_terminate;
-            }
-            group_iter -= 1;
-        }
-    }
-
-    // Rewrite to be MSD to LSD.
-    internal_string_builder_reverse(&sb, prefix_i, sb.len);
-nul_terminate:
     return string_to_cstring(&sb, NULL);
 }
 
@@ -154,26 +142,81 @@ i128_hex(i128 a, Allocator allocator)
 int
 main(void)
 {
-    Arena arena;
+    Growing_Arena arena;
     Allocator allocator;
+    Intern intern;
     char buf[BUFSIZ];
 
-    arena_init(&arena, buf, sizeof(buf));
-    allocator = arena_allocator(&arena);
+    // The start of a codepoint cut off by the end of the previous chunk, for
+    // lines longer than `buf`.
+    char carry[UTF8_MAX_RUNE_SIZE - 1];
+    size_t carry_len = 0;
+
+    growing_arena_init(&arena, /*block_size=*/0, heap_allocator());
+    allocator = growing_arena_allocator(&arena);
+
+    // Only holds the keywords, as the lexer never adds identifiers to it.
+    intern_init(&intern, heap_allocator());
+    if (!lexer_intern_keywords(&intern)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    // Static as it is rather big due to the call site table.
+    static Tracking_Allocator tracker;
+    tracking_allocator_init(&tracker, allocator);
+    allocator = tracking_allocator(&tracker);
+#endif // BIGINT_TRACK_ALLOCATIONS
+
+#ifdef BIGINT_TRACE_ALLOCATIONS
+    Trace_Recorder recorder;
+    FILE *trace_file = fopen(BIGINT_TRACE_ALLOCATIONS, "wb");
+    if (trace_file == NULL
+        || !trace_recorder_init(&recorder, allocator, trace_file, heap_allocator()))
+    {
+        fprintf(stderr, "Failed to open '%s'\n", BIGINT_TRACE_ALLOCATIONS);
+        return 1;
+    }
+    allocator = trace_recorder_allocator(&recorder);
+#endif // BIGINT_TRACE_ALLOCATIONS
     for (;;) {
+        Temp_Growing_Arena_Memory temp;
         Parser p;
         Value v;
         String s;
+        size_t invalid;
         Parser_Error err;
 
         fputs("bigint> ", stdout);
-        s.data = fgets(buf, sizeof(buf), stdin);
+        memcpy(buf, carry, carry_len);
+        s.data = fgets(buf + carry_len, cast(int)(sizeof(buf) - carry_len), stdin);
         if (s.data == NULL) {
             fputc('\n', stdout);
             break;
         }
-        s.len = strcspn(buf, "\r\n");
-        parser_init(&p, s, (Allocator){NULL, NULL});
+        s.data = buf;
+        s.len  = carry_len + strcspn(buf + carry_len, "\r\n");
+
+        // No newline means the line goes on in the next chunk, so do not
+        // judge a sequence that it splits until that chunk is in.
+        carry_len = 0;
+        if (buf[s.len] == '\0' && !feof(stdin)) {
+            carry_len = utf8_incomplete_suffix(s);
+            s.len    -= carry_len;
+            memcpy(carry, buf + s.len, carry_len);
+        }
+
+        // Reject binary garbage before the lexer ever sees it.
+        invalid = utf8_find_invalid(s);
+        if (invalid < s.len) {
+            eprintfln("Invalid UTF-8 at byte %zu.", invalid);
+            continue;
+        }
+
+        // Everything allocated for this line is dropped at the end of it.
+        temp = temp_growing_arena_memory_begin(&arena);
+        parser_init(&p, s, &intern, allocator);
 
         v.type    = VALUE_INTEGER;
         v.integer = I128_ZERO;
@@ -190,9 +233,25 @@ main(void)
                 break;
             }
         }
-        arena_free_all(&arena);
+        temp_growing_arena_memory_end(temp);
+#ifdef BIGINT_TRACK_ALLOCATIONS
+        tracking_allocator_free_all(&tracker);
+#endif // BIGINT_TRACK_ALLOCATIONS
+#ifdef BIGINT_TRACE_ALLOCATIONS
+        trace_recorder_free_all(&recorder);
+#endif // BIGINT_TRACE_ALLOCATIONS
     }
 
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    tracking_allocator_report(&tracker, stderr);
+#endif // BIGINT_TRACK_ALLOCATIONS
+
+#ifdef BIGINT_TRACE_ALLOCATIONS
+    trace_recorder_destroy(&recorder);
+    fclose(trace_file);
+#endif // BIGINT_TRACE_ALLOCATIONS
+    intern_destroy(&intern);
+    growing_arena_destroy(&arena);
     return 0;
 }
 
@@ -205,6 +264,7 @@ main(void)
 // bigint
 #include <mem/allocator.c>
 #include <utils/strings.c>
+#include <utils/rope.c>
 #include "bigint.c"
 
 // main
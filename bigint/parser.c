@@ -3,6 +3,7 @@
 // projects
 #include <mem/allocator.c>
 #include <utils/strings.c>
+#include <utils/intern.c>
 
 // parser
 #include "parser.h"
@@ -37,9 +38,9 @@ static Parser_Rule
 parser_get_rule(Token_Type t);
 
 void
-parser_init(Parser *p, String input, Allocator allocator)
+parser_init(Parser *p, String input, const Intern *intern, Allocator allocator)
 {
-    lexer_init(&p->lexer, input);
+    lexer_init(&p->lexer, input, intern);
     p->intermediates = NULL;
     p->error_code    = PARSER_OK;
     p->allocator     = allocator;
@@ -44,8 +44,11 @@ typedef enum {
     PREC_UNARY,      // + -
 } Precedence;
 
+
+/** @param intern  Looks up keywords and identifiers, if not `NULL`. See
+ *  `lexer_init`. */
 void
-parser_init(Parser *p, String input, Allocator allocator);
+parser_init(Parser *p, String input, const Intern *intern, Allocator allocator);
 
 Parser_Error
 parser_parse(Parser *p, Value *dst);
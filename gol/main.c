@@ -4,6 +4,9 @@
 // main
 #include <mem/allocator.c>
 #include <mem/arena.c>
+#include <mem/frame.c>
+#include <mem/growing_arena.c>
+#include <mem/heap.c>
 #include "raylib.h"
 
 // 5:4 ratio
@@ -17,6 +20,9 @@
 // 0.2 seconds per tick
 #define TARGET_FPS 12
 
+// Per-tick scratch, e.g. the next generation of the grid.
+#define FRAME_BUFFER_SIZE   (16 * 1024)
+
 
 // Grid points are 2D coordinates, in pixels, adjusted for `POINT_SCALE`
 // and `TEXT_OFFSET`.
@@ -180,14 +186,14 @@ render(Grid *g, int *ticks)
 int
 main(int argc, char *argv[])
 {
-    // int x = (((GRID_ROWS * GRID_COLS) / GRID_LIMB_TYPE_BITS) + 1) * sizeof(GRID_LIMB_TYPE) * 2;
-    char arena_buf[BUFSIZ];
-    Arena arena;
-    Grid *g, *scratch;
+    static unsigned char frame_buf[FRAME_BUFFER_SIZE];
+    Frame_Allocator frame;
+    Growing_Arena arena;
+    Grid *g;
 
-    arena_init(&arena, arena_buf, sizeof(arena_buf));
-    g       = grid_make(GRID_ROWS, GRID_COLS, arena_allocator(&arena));
-    scratch = grid_make_copy(g, arena_allocator(&arena));
+    growing_arena_init(&arena, /*block_size=*/0, heap_allocator());
+    frame_allocator_init(&frame, frame_buf, sizeof(frame_buf), /*lifetime=*/1);
+    g = grid_make(GRID_ROWS, GRID_COLS, growing_arena_allocator(&arena));
 
     if (argc > 1) {
         const char *s;
@@ -198,11 +204,13 @@ main(int argc, char *argv[])
         f = fopen(s, "r");
         if (f == NULL) {
             eprintfln("Failed to open '%s'.", s);
+            growing_arena_destroy(&arena);
             return 1;
         }
         ok = grid_copy_file(g, f);
         fclose(f);
         if (!ok) {
+            growing_arena_destroy(&arena);
             return 1;
         }
     } else {
@@ -231,10 +239,14 @@ main(int argc, char *argv[])
         if (is_paused && !IsKeyDown(KEY_N)) {
             ticks -= 1;
         } else {
+            // Recycled once the frame is over.
+            Grid *scratch = grid_make(g->rows, g->cols, frame_allocator(&frame));
             grid_update(g, scratch);
         }
         render(g, &ticks);
+        frame_allocator_advance(&frame);
     }
     CloseWindow();
+    growing_arena_destroy(&arena);
     return 0;
 }
@@ -0,0 +1,620 @@
+#include <stdio.h>  // printf, fputs, fputc
+#include <string.h> // memcpy
+
+#include <bench.h>
+
+#include "checked.c"
+#include "limbs.c"
+
+// The reference results are computed exactly in 128 bits.
+#if !defined(__SIZEOF_INT128__)
+#error "math/bench.c needs `__int128`."
+#endif // __SIZEOF_INT128__
+
+__extension__ typedef unsigned __int128 bench_u128;
+__extension__ typedef __int128          bench_i128;
+
+// Random operand pairs checked on top of the edge cases.
+#define BENCH_RANDOM_CHECKS (1 << 22)
+
+// Random arrays per `limbs_*` function, and their maximum length.
+#define BENCH_LIMB_CHECKS   (1 << 14)
+#define BENCH_LIMB_MAX      40
+
+// Limbs per carry chain, and chains per measurement.
+#define BENCH_LIMBS         1024
+#define BENCH_PASSES        20000
+
+
+
+/** @brief Mostly uniform, but often close to 0, a power of 2 or a limit, as
+ *  overflow bugs tend to hide there. */
+static u64
+bench_rng_operand(void)
+{
+    u64 r = bench_rng_next();
+    switch (r & 7) {
+    case 0: return r >> (r >> 58);
+    case 1: return U64_MAX - (r >> 40);
+    case 2: return cast(u64)1 << (r >> 58);
+    case 3: return (cast(u64)1 << (r >> 58)) - 1;
+    }
+    return bench_rng_next();
+}
+
+// REFERENCE =============================================================== {{{
+
+// Same contract as the functions in checked.c, including that a carry is
+// added (or subtracted) to the already wrapped result of the first step.
+
+static bool
+bench_ref_u64(u64 *dst, bench_u128 exact)
+{
+    *dst = cast(u64)exact;
+    return (exact >> 64) != 0;
+}
+
+static bool
+bench_ref_i64(i64 *dst, bench_i128 exact)
+{
+    *dst = cast(i64)cast(u64)exact;
+    return exact < I64_MIN || I64_MAX < exact;
+}
+
+static bool
+bench_ref_u64_add_carry(u64 *dst, u64 a, u64 b, u64 carry)
+{
+    bool c1 = bench_ref_u64(dst, cast(bench_u128)a + b);
+    bool c2 = bench_ref_u64(dst, cast(bench_u128)*dst + carry);
+    return c1 || c2;
+}
+
+static bool
+bench_ref_u64_sub_carry(u64 *dst, u64 a, u64 b, u64 carry)
+{
+    bool c1 = bench_ref_u64(dst, cast(bench_u128)a - b);
+    bool c2 = bench_ref_u64(dst, cast(bench_u128)*dst - carry);
+    return c1 || c2;
+}
+
+static bool
+bench_ref_i64_add_carry(i64 *dst, i64 a, i64 b, i64 carry)
+{
+    bool c1 = bench_ref_i64(dst, cast(bench_i128)a + b);
+    bool c2 = bench_ref_i64(dst, cast(bench_i128)*dst + carry);
+    return c1 || c2;
+}
+
+static bool
+bench_ref_i64_sub_carry(i64 *dst, i64 a, i64 b, i64 carry)
+{
+    bool c1 = bench_ref_i64(dst, cast(bench_i128)a - b);
+    bool c2 = bench_ref_i64(dst, cast(bench_i128)*dst - carry);
+    return c1 || c2;
+}
+
+static u64
+bench_ref_u64_saturate(bench_u128 exact, bool negative)
+{
+    if (negative) {
+        return 0;
+    }
+    return (exact > U64_MAX) ? U64_MAX : cast(u64)exact;
+}
+
+static i64
+bench_ref_i64_saturate(bench_i128 exact)
+{
+    if (exact < I64_MIN) {
+        return I64_MIN;
+    }
+    return (exact > I64_MAX) ? I64_MAX : cast(i64)exact;
+}
+
+// === }}} =====================================================================
+
+// CHECKS ================================================================== {{{
+
+static const u64
+BENCH_U64_EDGES[] = {
+    0, 1, 2, 3, 0xff, 0xffffffff, 0x100000000, 0x100000001, 0x1ffffffff,
+    U64_MAX / 3, I64_MAX - 1, I64_MAX, cast(u64)I64_MAX + 1,
+    cast(u64)I64_MAX + 2, U64_MAX - 2, U64_MAX - 1, U64_MAX,
+};
+
+static const i64
+BENCH_I64_EDGES[] = {
+    I64_MIN, I64_MIN + 1, I64_MIN + 2, -0x100000000, -0xb504f334, -0xb504f333,
+    -0xffffffff, -3, -2, -1, 0, 1, 2, 3, 0xffffffff, 0xb504f333, 0xb504f334,
+    0x100000000, I64_MAX - 2, I64_MAX - 1, I64_MAX,
+};
+
+static size_t
+bench_failures;
+
+static void
+bench_check_u64(const char *name, u64 a, u64 b, u64 c,
+    bool got_carry, u64 got, bool want_carry, u64 want)
+{
+    if (got_carry == want_carry && got == want) {
+        return;
+    }
+    bench_failures += 1;
+    if (bench_failures <= 10) {
+        printfln("%s(%#llx, %#llx, %#llx): got (%i, %#llx), want (%i, %#llx)",
+            name, cast(unsigned long long)a, cast(unsigned long long)b,
+            cast(unsigned long long)c, got_carry, cast(unsigned long long)got,
+            want_carry, cast(unsigned long long)want);
+    }
+}
+
+static void
+bench_check_i64(const char *name, i64 a, i64 b, i64 c,
+    bool got_carry, i64 got, bool want_carry, i64 want)
+{
+    if (got_carry == want_carry && got == want) {
+        return;
+    }
+    bench_failures += 1;
+    if (bench_failures <= 10) {
+        printfln("%s(%lli, %lli, %lli): got (%i, %lli), want (%i, %lli)",
+            name, cast(long long)a, cast(long long)b, cast(long long)c,
+            got_carry, cast(long long)got, want_carry, cast(long long)want);
+    }
+}
+
+static void
+bench_check_u64_all(u64 a, u64 b, u64 c)
+{
+    u64 got, want;
+    bool got_carry, want_carry;
+
+    got_carry  = u64_checked_add(&got, a, b);
+    want_carry = bench_ref_u64(&want, cast(bench_u128)a + b);
+    bench_check_u64("u64_checked_add", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = u64_checked_sub(&got, a, b);
+    want_carry = bench_ref_u64(&want, cast(bench_u128)a - b);
+    bench_check_u64("u64_checked_sub", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = u64_checked_mul(&got, a, b);
+    want_carry = bench_ref_u64(&want, cast(bench_u128)a * b);
+    bench_check_u64("u64_checked_mul", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = u64_checked_add_carry(&got, a, b, c);
+    want_carry = bench_ref_u64_add_carry(&want, a, b, c);
+    bench_check_u64("u64_checked_add_carry", a, b, c, got_carry, got, want_carry, want);
+
+    got_carry  = u64_checked_sub_carry(&got, a, b, c);
+    want_carry = bench_ref_u64_sub_carry(&want, a, b, c);
+    bench_check_u64("u64_checked_sub_carry", a, b, c, got_carry, got, want_carry, want);
+
+    got  = u64_saturating_add(a, b);
+    want = bench_ref_u64_saturate(cast(bench_u128)a + b, false);
+    bench_check_u64("u64_saturating_add", a, b, 0, false, got, false, want);
+
+    got  = u64_saturating_sub(a, b);
+    want = bench_ref_u64_saturate(cast(bench_u128)a - b, a < b);
+    bench_check_u64("u64_saturating_sub", a, b, 0, false, got, false, want);
+
+    got  = u64_saturating_mul(a, b);
+    want = bench_ref_u64_saturate(cast(bench_u128)a * b, false);
+    bench_check_u64("u64_saturating_mul", a, b, 0, false, got, false, want);
+
+    {
+        bench_u128 prod = cast(bench_u128)a * b;
+        u64 got_hi;
+
+        got = u64_mul_wide(a, b, &got_hi);
+        bench_check_u64("u64_mul_wide (lo)", a, b, 0, false, got, false, cast(u64)prod);
+        bench_check_u64("u64_mul_wide (hi)", a, b, 0, false, got_hi, false,
+            cast(u64)(prod >> 64));
+    }
+
+    // Reduce `a` into a valid upper half for the divisor `c`.
+    if (c != 0) {
+        bench_u128 num = (cast(bench_u128)(a % c) << 64) | b;
+        u64 got_rem;
+
+        got = u128_div_u64(a % c, b, c, &got_rem);
+        bench_check_u64("u128_div_u64 (quot)", a % c, b, c, false, got, false,
+            cast(u64)(num / c));
+        bench_check_u64("u128_div_u64 (rem)", a % c, b, c, false, got_rem, false,
+            cast(u64)(num % c));
+    }
+}
+
+static void
+bench_check_i64_all(i64 a, i64 b, i64 c)
+{
+    i64 got, want;
+    bool got_carry, want_carry;
+
+    got_carry  = i64_checked_add(&got, a, b);
+    want_carry = bench_ref_i64(&want, cast(bench_i128)a + b);
+    bench_check_i64("i64_checked_add", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = i64_checked_sub(&got, a, b);
+    want_carry = bench_ref_i64(&want, cast(bench_i128)a - b);
+    bench_check_i64("i64_checked_sub", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = i64_checked_mul(&got, a, b);
+    want_carry = bench_ref_i64(&want, cast(bench_i128)a * b);
+    bench_check_i64("i64_checked_mul", a, b, 0, got_carry, got, want_carry, want);
+
+    got_carry  = i64_checked_add_carry(&got, a, b, c);
+    want_carry = bench_ref_i64_add_carry(&want, a, b, c);
+    bench_check_i64("i64_checked_add_carry", a, b, c, got_carry, got, want_carry, want);
+
+    got_carry  = i64_checked_sub_carry(&got, a, b, c);
+    want_carry = bench_ref_i64_sub_carry(&want, a, b, c);
+    bench_check_i64("i64_checked_sub_carry", a, b, c, got_carry, got, want_carry, want);
+
+    got  = i64_saturating_add(a, b);
+    want = bench_ref_i64_saturate(cast(bench_i128)a + b);
+    bench_check_i64("i64_saturating_add", a, b, 0, false, got, false, want);
+
+    got  = i64_saturating_sub(a, b);
+    want = bench_ref_i64_saturate(cast(bench_i128)a - b);
+    bench_check_i64("i64_saturating_sub", a, b, 0, false, got, false, want);
+
+    got  = i64_saturating_mul(a, b);
+    want = bench_ref_i64_saturate(cast(bench_i128)a * b);
+    bench_check_i64("i64_saturating_mul", a, b, 0, false, got, false, want);
+}
+
+
+/** @brief Every combination of edge cases, carries included, then random
+ *  operands.
+ *
+ * @return `true` if every result matched the reference.
+ */
+static bool
+bench_check(void)
+{
+    for (size_t i = 0; i < count_of(BENCH_U64_EDGES); i += 1) {
+        for (size_t j = 0; j < count_of(BENCH_U64_EDGES); j += 1) {
+            for (size_t k = 0; k < count_of(BENCH_U64_EDGES); k += 1) {
+                bench_check_u64_all(BENCH_U64_EDGES[i], BENCH_U64_EDGES[j],
+                    BENCH_U64_EDGES[k]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count_of(BENCH_I64_EDGES); i += 1) {
+        for (size_t j = 0; j < count_of(BENCH_I64_EDGES); j += 1) {
+            for (size_t k = 0; k < count_of(BENCH_I64_EDGES); k += 1) {
+                bench_check_i64_all(BENCH_I64_EDGES[i], BENCH_I64_EDGES[j],
+                    BENCH_I64_EDGES[k]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < BENCH_RANDOM_CHECKS; i += 1) {
+        u64 a = bench_rng_operand();
+        u64 b = bench_rng_operand();
+        u64 c = bench_rng_next() & 1;
+        bench_check_u64_all(a, b, c);
+        bench_check_i64_all(cast(i64)a, cast(i64)b, cast(i64)c);
+        // Again with a whole-limb divisor, which a carry never is.
+        bench_check_u64_all(a, b, bench_rng_operand());
+    }
+    return bench_failures == 0;
+}
+
+// === }}} =====================================================================
+
+// LIMBS =================================================================== {{{
+
+// One limb at a time in 128 bits, independently of the unrolled loops.
+
+static u64
+bench_ref_add_n(u64 *dst, const u64 *a, const u64 *b, size_t n)
+{
+    bench_u128 acc = 0;
+    for (size_t i = 0; i < n; i += 1) {
+        acc    = acc + a[i] + b[i];
+        dst[i] = cast(u64)acc;
+        acc  >>= 64;
+    }
+    return cast(u64)acc;
+}
+
+static u64
+bench_ref_sub_n(u64 *dst, const u64 *a, const u64 *b, size_t n)
+{
+    u64 borrow = 0;
+    for (size_t i = 0; i < n; i += 1) {
+        bench_u128 diff = cast(bench_u128)a[i] - b[i] - borrow;
+        dst[i] = cast(u64)diff;
+        borrow = cast(u64)(diff >> 64) & 1;
+    }
+    return borrow;
+}
+
+static u64
+bench_ref_addmul_1(u64 *dst, const u64 *a, size_t n, u64 b, bool accumulate)
+{
+    bench_u128 acc = 0;
+    for (size_t i = 0; i < n; i += 1) {
+        acc   += cast(bench_u128)a[i] * b + (accumulate ? dst[i] : 0);
+        dst[i] = cast(u64)acc;
+        acc  >>= 64;
+    }
+    return cast(u64)acc;
+}
+
+static u64
+bench_ref_submul_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 carry = 0;
+    for (size_t i = 0; i < n; i += 1) {
+        bench_u128 prod = cast(bench_u128)a[i] * b + carry;
+        u64        lo   = cast(u64)prod;
+        carry  = cast(u64)(prod >> 64) + (dst[i] < lo);
+        dst[i] = dst[i] - lo;
+    }
+    return carry;
+}
+
+static u64
+bench_ref_divrem_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 rem = 0;
+    for (size_t i = n; i > 0; i -= 1) {
+        bench_u128 num = (cast(bench_u128)rem << 64) | a[i - 1];
+        dst[i - 1] = cast(u64)(num / b);
+        rem        = cast(u64)(num % b);
+    }
+    return rem;
+}
+
+static void
+bench_check_limbs_result(const char *name, const u64 *got, const u64 *want,
+    size_t n, u64 got_carry, u64 want_carry)
+{
+    bool same = got_carry == want_carry;
+    for (size_t i = 0; i < n; i += 1) {
+        same = same && got[i] == want[i];
+    }
+    if (!same) {
+        if (bench_failures < 10) {
+            printfln("%s: n=%zu, carry %llu (want %llu)", name, n,
+                cast(unsigned long long)got_carry,
+                cast(unsigned long long)want_carry);
+        }
+        bench_failures += 1;
+    }
+}
+
+/** @brief Each `limbs_*` function on random arrays of every length up to
+ *  `BENCH_LIMB_MAX`, both into a separate array and in place.
+ *
+ * @return `true` if every result matched the reference.
+ */
+static bool
+bench_check_limbs(void)
+{
+    u64 a[BENCH_LIMB_MAX], b[BENCH_LIMB_MAX];
+    u64 got[BENCH_LIMB_MAX], want[BENCH_LIMB_MAX];
+    u64 got_carry, want_carry;
+
+    for (size_t iter = 0; iter < BENCH_LIMB_CHECKS; iter += 1) {
+        size_t n = iter % (BENCH_LIMB_MAX + 1);
+        u64    m = bench_rng_operand();
+        for (size_t i = 0; i < n; i += 1) {
+            a[i] = bench_rng_operand();
+            b[i] = bench_rng_operand();
+        }
+
+        want_carry = bench_ref_add_n(want, a, b, n);
+        got_carry  = limbs_add_n(got, a, b, n);
+        bench_check_limbs_result("limbs_add_n", got, want, n, got_carry, want_carry);
+        memcpy(got, a, n * sizeof(u64));
+        got_carry  = limbs_add_n(got, got, b, n);
+        bench_check_limbs_result("limbs_add_n (in place)", got, want, n, got_carry, want_carry);
+
+        want_carry = bench_ref_sub_n(want, a, b, n);
+        got_carry  = limbs_sub_n(got, a, b, n);
+        bench_check_limbs_result("limbs_sub_n", got, want, n, got_carry, want_carry);
+        memcpy(got, a, n * sizeof(u64));
+        got_carry  = limbs_sub_n(got, got, b, n);
+        bench_check_limbs_result("limbs_sub_n (in place)", got, want, n, got_carry, want_carry);
+
+        want_carry = bench_ref_addmul_1(want, a, n, m, false);
+        got_carry  = limbs_mul_1(got, a, n, m);
+        bench_check_limbs_result("limbs_mul_1", got, want, n, got_carry, want_carry);
+        memcpy(got, a, n * sizeof(u64));
+        got_carry  = limbs_mul_1(got, got, n, m);
+        bench_check_limbs_result("limbs_mul_1 (in place)", got, want, n, got_carry, want_carry);
+
+        memcpy(want, b, n * sizeof(u64));
+        memcpy(got, b, n * sizeof(u64));
+        want_carry = bench_ref_addmul_1(want, a, n, m, true);
+        got_carry  = limbs_addmul_1(got, a, n, m);
+        bench_check_limbs_result("limbs_addmul_1", got, want, n, got_carry, want_carry);
+
+        memcpy(want, b, n * sizeof(u64));
+        memcpy(got, b, n * sizeof(u64));
+        want_carry = bench_ref_submul_1(want, a, n, m);
+        got_carry  = limbs_submul_1(got, a, n, m);
+        bench_check_limbs_result("limbs_submul_1", got, want, n, got_carry, want_carry);
+
+        m = (m != 0) ? m : 1;
+        want_carry = bench_ref_divrem_1(want, a, n, m);
+        got_carry  = limbs_divrem_1(got, a, n, m);
+        bench_check_limbs_result("limbs_divrem_1", got, want, n, got_carry, want_carry);
+        memcpy(got, a, n * sizeof(u64));
+        got_carry  = limbs_divrem_1(got, got, n, m);
+        bench_check_limbs_result("limbs_divrem_1 (in place)", got, want, n, got_carry, want_carry);
+    }
+    return bench_failures == 0;
+}
+
+// === }}} =====================================================================
+
+// TIMING ================================================================== {{{
+
+static u64 bench_x[BENCH_LIMBS];
+static u64 bench_y[BENCH_LIMBS];
+static u64 bench_z[BENCH_LIMBS];
+
+static volatile u64
+bench_sink;
+
+static u64
+bench_add_chain(void)
+{
+    bool carry = false;
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        carry = u64_checked_add_carry(&bench_z[i], bench_x[i], bench_y[i], carry);
+    }
+    return carry;
+}
+
+static u64
+bench_sub_chain(void)
+{
+    bool borrow = false;
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        borrow = u64_checked_sub_carry(&bench_z[i], bench_x[i], bench_y[i], borrow);
+    }
+    return borrow;
+}
+
+static u64
+bench_u64_mul(void)
+{
+    u64 overflows = 0;
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        overflows += u64_checked_mul(&bench_z[i], bench_x[i], bench_y[i]);
+    }
+    return overflows;
+}
+
+static u64
+bench_i64_mul(void)
+{
+    u64 overflows = 0;
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        i64 prod;
+        overflows  += i64_checked_mul(&prod, cast(i64)bench_x[i], cast(i64)bench_y[i]);
+        bench_z[i]  = cast(u64)prod;
+    }
+    return overflows;
+}
+
+static u64
+bench_i64_add(void)
+{
+    u64 overflows = 0;
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        i64 sum;
+        overflows  += i64_checked_add(&sum, cast(i64)bench_x[i], cast(i64)bench_y[i]);
+        bench_z[i]  = cast(u64)sum;
+    }
+    return overflows;
+}
+
+static u64
+bench_limbs_add_n(void)
+{
+    return limbs_add_n(bench_z, bench_x, bench_y, BENCH_LIMBS);
+}
+
+static u64
+bench_limbs_sub_n(void)
+{
+    return limbs_sub_n(bench_z, bench_x, bench_y, BENCH_LIMBS);
+}
+
+static u64
+bench_limbs_mul_1(void)
+{
+    return limbs_mul_1(bench_z, bench_x, BENCH_LIMBS, bench_y[0]);
+}
+
+static u64
+bench_limbs_addmul_1(void)
+{
+    return limbs_addmul_1(bench_z, bench_x, BENCH_LIMBS, bench_y[0]);
+}
+
+static u64
+bench_limbs_submul_1(void)
+{
+    return limbs_submul_1(bench_z, bench_x, BENCH_LIMBS, bench_y[0]);
+}
+
+static u64
+bench_limbs_divrem_1(void)
+{
+    return limbs_divrem_1(bench_z, bench_x, BENCH_LIMBS, bench_y[0] | 1);
+}
+
+static void
+bench_run(const char *name, u64 (*fn)(void))
+{
+    u64 start, stop;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_PASSES; i += 1) {
+        // Read `bench_z` too, so that the stores to it are kept.
+        bench_sink = fn() + bench_z[BENCH_LIMBS / 2];
+    }
+    stop = bench_now_ns();
+
+    printfln("    %-14s %6.3f ns/limb", name,
+        cast(f64)(stop - start) / (cast(f64)BENCH_PASSES * BENCH_LIMBS));
+}
+
+// === }}} =====================================================================
+
+int
+main(void)
+{
+    fputs("checked:", stdout);
+#if defined(MATH_CHECKED_PORTABLE)
+    fputs(" portable", stdout);
+#endif // MATH_CHECKED_PORTABLE
+#if defined(MATH_CHECKED_BUILTINS)
+    fputs(" builtins", stdout);
+#endif // MATH_CHECKED_BUILTINS
+#if defined(MATH_CHECKED_ADDCARRY)
+    fputs(" addcarry", stdout);
+#endif // MATH_CHECKED_ADDCARRY
+#if defined(MATH_CHECKED_INT128)
+    fputs(" int128", stdout);
+#endif // MATH_CHECKED_INT128
+#if defined(MATH_CHECKED_DIVQ)
+    fputs(" divq", stdout);
+#endif // MATH_CHECKED_DIVQ
+    fputc('\n', stdout);
+
+    if (!bench_check()) {
+        printfln("%zu results differ from the reference", bench_failures);
+        return 1;
+    }
+    if (!bench_check_limbs()) {
+        printfln("%zu limb results differ from the reference", bench_failures);
+        return 1;
+    }
+    println("all results match the reference");
+
+    for (size_t i = 0; i < BENCH_LIMBS; i += 1) {
+        bench_x[i] = bench_rng_operand();
+        bench_y[i] = bench_rng_operand();
+    }
+    bench_run("add chain", bench_add_chain);
+    bench_run("sub chain", bench_sub_chain);
+    bench_run("u64 mul", bench_u64_mul);
+    bench_run("i64 add", bench_i64_add);
+    bench_run("i64 mul", bench_i64_mul);
+    bench_run("limbs_add_n", bench_limbs_add_n);
+    bench_run("limbs_sub_n", bench_limbs_sub_n);
+    bench_run("limbs_mul_1", bench_limbs_mul_1);
+    bench_run("limbs_addmul_1", bench_limbs_addmul_1);
+    bench_run("limbs_submul_1", bench_limbs_submul_1);
+    bench_run("limbs_divrem_1", bench_limbs_divrem_1);
+    return 0;
+}
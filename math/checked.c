@@ -1,8 +1,40 @@
 #include "checked.h"
 
+// Define to use the portable code only, e.g. to compare against the rest.
+// #define MATH_CHECKED_PORTABLE
+
+// `__builtin_{add,sub,mul}_overflow` compile down to the flag-setting
+// instruction followed by a flag read.
+#if !defined(MATH_CHECKED_PORTABLE) && (defined(__GNUC__) || defined(__clang__))
+#define MATH_CHECKED_BUILTINS
+#endif // MATH_CHECKED_PORTABLE
+
+// `adc`/`sbb` taking the carry of the previous limb.
+#if !defined(MATH_CHECKED_PORTABLE) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h> // _addcarry_u64, _subborrow_u64
+#define MATH_CHECKED_ADDCARRY
+#endif // MATH_CHECKED_PORTABLE
+
+// For multiplication, where the builtins are missing.
+#if !defined(MATH_CHECKED_PORTABLE) && defined(__SIZEOF_INT128__)
+#define MATH_CHECKED_INT128
+__extension__ typedef unsigned __int128 checked_u128;
+__extension__ typedef __int128          checked_i128;
+#endif // MATH_CHECKED_PORTABLE
+
+// `divq` divides 128 by 64 bits directly. Dividing a `__int128` instead calls
+// into a library routine that has to handle 128-bit divisors too.
+#if !defined(MATH_CHECKED_PORTABLE) && defined(__x86_64__) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define MATH_CHECKED_DIVQ
+#endif // MATH_CHECKED_PORTABLE
+
 bool
 u64_checked_add(u64 *dst, u64 a, u64 b)
 {
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_add_overflow(a, b, dst);
+#else // !MATH_CHECKED_BUILTINS
     u64 sum;
     bool carry;
 
@@ -17,6 +49,7 @@ u64_checked_add(u64 *dst, u64 a, u64 b)
     carry = a > U64_MAX - b;
     *dst  = sum;
     return carry;
+#endif // MATH_CHECKED_BUILTINS
 }
 
 bool
@@ -25,6 +58,18 @@ u64_checked_add_carry(u64 *dst, u64 a, u64 b, u64 carry)
     u64 sum;
     bool c1, c2;
 
+#if defined(MATH_CHECKED_ADDCARRY)
+    // The intrinsic takes any nonzero carry to mean 1, so it only covers the
+    // boolean case. That is the one carry chains hit, and once inlined into
+    // one the check folds away.
+    if (carry <= 1) {
+        unsigned long long res;
+        c1   = _addcarry_u64(cast(unsigned char)carry, a, b, &res) != 0;
+        *dst = cast(u64)res;
+        return c1;
+    }
+#endif // MATH_CHECKED_ADDCARRY
+
     // Overflow check (64-bit unsigned addition with carry):
     //
     //      a + b + carry > MAX
@@ -46,6 +91,9 @@ u64_checked_add_carry(u64 *dst, u64 a, u64 b, u64 carry)
 bool
 i64_checked_add(i64 *dst, i64 a, i64 b)
 {
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_add_overflow(a, b, dst);
+#else // !MATH_CHECKED_BUILTINS
     i64 sum;
     bool a_sign, b_sign, sum_sign, overflow = false;
 
@@ -71,7 +119,8 @@ i64_checked_add(i64 *dst, i64 a, i64 b)
     // Thus, the overflow check can be generalized as:
     //      arguments signs match AND result sign does not match
     //
-    sum      = a + b;
+    // Wrap around in unsigned, as signed overflow is undefined.
+    sum      = cast(i64)(cast(u64)a + cast(u64)b);
     a_sign   = a < 0;
     b_sign   = b < 0;
     sum_sign = sum < 0;
@@ -79,6 +128,7 @@ i64_checked_add(i64 *dst, i64 a, i64 b)
     overflow = a_sign == b_sign && sum_sign != a_sign;
     *dst     = sum;
     return overflow;
+#endif // MATH_CHECKED_BUILTINS
 }
 
 bool
@@ -100,6 +150,9 @@ i64_checked_add_carry(i64 *dst, i64 a, i64 b, i64 carry)
 bool
 u64_checked_sub(u64 *dst, u64 a, u64 b)
 {
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_sub_overflow(a, b, dst);
+#else // !MATH_CHECKED_BUILTINS
     u64 diff;
     bool carry;
     // a - b < 0
@@ -108,6 +161,7 @@ u64_checked_sub(u64 *dst, u64 a, u64 b)
     carry = a < b;
     *dst  = diff;
     return carry;
+#endif // MATH_CHECKED_BUILTINS
 }
 
 bool
@@ -116,6 +170,16 @@ u64_checked_sub_carry(u64 *dst, u64 a, u64 b, u64 carry)
     u64 diff;
     bool c1, c2;
 
+#if defined(MATH_CHECKED_ADDCARRY)
+    // See `u64_checked_add_carry`.
+    if (carry <= 1) {
+        unsigned long long res;
+        c1   = _subborrow_u64(cast(unsigned char)carry, a, b, &res) != 0;
+        *dst = cast(u64)res;
+        return c1;
+    }
+#endif // MATH_CHECKED_ADDCARRY
+
     // Overflow check (64-bit unsigned subtraction with carry)
     //
     //      (a - b) - carry < 0
@@ -136,6 +200,9 @@ u64_checked_sub_carry(u64 *dst, u64 a, u64 b, u64 carry)
 bool
 i64_checked_sub(i64 *dst, i64 a, i64 b)
 {
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_sub_overflow(a, b, dst);
+#else // !MATH_CHECKED_BUILTINS
     i64 diff;
     bool a_sign, b_sign, diff_sign, overflow;
 
@@ -159,13 +226,14 @@ i64_checked_sub(i64 *dst, i64 a, i64 b)
     //
     //      e.g. IMAX - (-1) = IMIN
     //
-    diff      = a - b;
+    diff      = cast(i64)(cast(u64)a - cast(u64)b);
     a_sign    = a < 0;
     b_sign    = b < 0;
     diff_sign = diff < 0;
     overflow  = a_sign != b_sign && diff_sign != a_sign;
     *dst      = diff;
     return overflow;
+#endif // MATH_CHECKED_BUILTINS
 }
 
 bool
@@ -187,6 +255,13 @@ i64_checked_sub_carry(i64 *dst, i64 a, i64 b, i64 carry)
 bool
 u64_checked_mul(u64 *dst, u64 a, u64 b)
 {
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_mul_overflow(a, b, dst);
+#elif defined(MATH_CHECKED_INT128)
+    checked_u128 prod = cast(checked_u128)a * b;
+    *dst = cast(u64)prod;
+    return (prod >> 64) != 0;
+#else // !MATH_CHECKED_BUILTINS && !MATH_CHECKED_INT128
     u64 prod;
     bool carry;
 
@@ -195,27 +270,288 @@ u64_checked_mul(u64 *dst, u64 a, u64 b)
     //      a * b > UMAX
     //      a > UMAX / b
     //
-    // ...except for `b == 0`. If either operand is zero we know the
-    // product is automatically zero.
+    // ...except for `b == 0`, where the product is always zero. Note that
+    // the wrapped product itself tells us nothing: 2^32 * 2^32 wraps to 0.
     prod  = a * b;
-    carry = prod > 0 && a > U64_MAX / b;
+    carry = b != 0 && a > U64_MAX / b;
     *dst  = prod;
     return carry;
+#endif // MATH_CHECKED_BUILTINS
 }
 
 bool
 i64_checked_mul(i64 *dst, i64 a, i64 b)
 {
-    i64 prod;
-    bool carry;
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_mul_overflow(a, b, dst);
+#elif defined(MATH_CHECKED_INT128)
+    checked_i128 prod = cast(checked_i128)a * b;
+    *dst = cast(i64)prod;
+    return prod < I64_MIN || I64_MAX < prod;
+#else // !MATH_CHECKED_BUILTINS && !MATH_CHECKED_INT128
+    u64 a_abs, b_abs, prod_abs, limit;
+    bool negative, carry;
 
     // Overflow check (64-bit signed multiplication):
     //
     //      a * b < IMIN or IMAX < a * b
-    //      a < IMIN / b or IMAX / b < a
     //
-    prod  = a * b;
-    carry = prod != 0 && (a < I64_MIN / b || I64_MAX / b < a);
-    *dst  = prod;
+    // Dividing by `b` would need the inequalities flipped for negative `b`,
+    // and `IMIN / -1` traps. Work with magnitudes instead, which always fit
+    // in a `u64`:
+    //
+    //      |a| * |b| > IMAX        if the signs match
+    //      |a| * |b| > IMAX + 1    if they differ
+    //
+    a_abs    = (a < 0) ? 0 - cast(u64)a : cast(u64)a;
+    b_abs    = (b < 0) ? 0 - cast(u64)b : cast(u64)b;
+    negative = (a < 0) != (b < 0);
+    limit    = cast(u64)I64_MAX + cast(u64)negative;
+    carry    = u64_checked_mul(&prod_abs, a_abs, b_abs) || prod_abs > limit;
+
+    // Two's complement multiplication only differs from unsigned in the
+    // upper half, so the wrapped product is the same.
+    *dst = cast(i64)(cast(u64)a * cast(u64)b);
     return carry;
+#endif // MATH_CHECKED_BUILTINS
+}
+
+u64
+u64_saturating_add(u64 a, u64 b)
+{
+    u64 sum;
+    return u64_checked_add(&sum, a, b) ? U64_MAX : sum;
+}
+
+u64
+u64_saturating_sub(u64 a, u64 b)
+{
+    u64 diff;
+    return u64_checked_sub(&diff, a, b) ? 0 : diff;
+}
+
+u64
+u64_saturating_mul(u64 a, u64 b)
+{
+    u64 prod;
+    return u64_checked_mul(&prod, a, b) ? U64_MAX : prod;
+}
+
+i64
+i64_saturating_add(i64 a, i64 b)
+{
+    i64 sum;
+
+    // Addition can only overflow if both operands have the same sign,
+    // and then it does so in the direction of that sign.
+    if (i64_checked_add(&sum, a, b)) {
+        return (a < 0) ? I64_MIN : I64_MAX;
+    }
+    return sum;
+}
+
+i64
+i64_saturating_sub(i64 a, i64 b)
+{
+    i64 diff;
+
+    // Subtraction can only overflow if the operands have different signs,
+    // and then it does so in the direction of the sign of `a`.
+    if (i64_checked_sub(&diff, a, b)) {
+        return (a < 0) ? I64_MIN : I64_MAX;
+    }
+    return diff;
+}
+
+i64
+i64_saturating_mul(i64 a, i64 b)
+{
+    i64 prod;
+    if (i64_checked_mul(&prod, a, b)) {
+        return ((a < 0) != (b < 0)) ? I64_MIN : I64_MAX;
+    }
+    return prod;
+}
+
+
+/** @link catid on stackoverflow: https://stackoverflow.com/a/51587262 */
+u64
+u64_mul_wide(u64 a, u64 b, u64 *hi)
+{
+#if defined(MATH_CHECKED_INT128)
+    // A single `mul` (or `mulx`, with BMI2 enabled).
+    checked_u128 prod = cast(checked_u128)a * b;
+    *hi = cast(u64)(prod >> 64);
+    return cast(u64)prod;
+#else // !MATH_CHECKED_INT128
+    u64 a0, a1, b0, b1, p00, p10, p01, p11, mid;
+    const u64 mask = U32_MAX;
+
+    // 64x64 multiplication results in 128-bit results. We simulate it by
+    // chopping it into multiple 32x32 multiplications with 64-bit results.
+    a0 =  a        & mask; // a[00:32]
+    a1 = (a >> 32) & mask; // a[32:64]
+    b0 =  b        & mask; // b[00:32]
+    b1 = (b >> 32) & mask; // b[32:64]
+
+    // 32x32 products sans place values.
+    //
+    // +----------------+---------------+---------------+---------------+
+    // |   dst[128.................64]  |  dst[64...................0]  |
+    // |   hi[64...00]  |  hi[32...00]  |  lo[64...32]  |  lo[32...00]  |
+    // +----------------+---------------+---------------+---------------+
+    // |                |               |           a1  |           a0  |
+    // | *              |               |           b1  |           b0  |
+    // +----------------+---------------+---------------+---------------+
+    // | =              |               |               |  p00 = a0*b0  |
+    // | +              |               |  p10 = a1*b0  |               |
+    // | +              |               |  p01 = a0*b1  |               |
+    // | +              |  p11 = a1*b1  |               |               |
+    // +----------------+---------------+---------------+---------------+
+    // | =              |               |  p00[64..32]  |  p00[32..00]  |
+    // | +              |  p10[64..32]  |  p10[32..00]  |               |
+    // | +              |  p01[64..32]  |  p01[32..00]  |               |
+    // | + p11[64..32]  |  p11[32..00]  |               |               |
+    // +----------------+---------------+---------------+---------------+
+    p00 = a0 * b0;
+    p10 = a1 * b0;
+    p01 = a0 * b1;
+    p11 = a1 * b1;
+
+    // Calculate part of 64x32 96-bit product `a * b0` that is to be
+    // part of dst[64...00].
+    //  = (a1 * b0) * (2**32)**1
+    //  + (a0 * b0) * (2**32)**0
+    //
+    // The 64x32 product goes into dst[96..00].
+    // It is split between dst.lo[64..00] and dst.hi[32..00].
+    //
+    //  p10[64..00] - Overlaps both intermediates, never overflows.
+    //  p01[32..00] - Overlaps the dst[64..00].
+    //  p00[64..32] - Only the upper half overlaps the 96-bit product.
+    //
+    // Concept check: (using `digits.py`)
+    // ```py
+    // bits = 32
+    // mask = int_max(u32) # 0b11111111111111111111111111111111
+    // a0 = mask
+    // a1 = mask
+    // b0 = mask
+    // b1 = mask
+    //
+    // p00 = a0 * b0
+    // p10 = a1 * b0
+    // p01 = a0 * b1
+    // mid = p10 + (p01 & mask) + (p00 >> bits)
+    //
+    // print(int_bin(p10, min_groups=2, group_size=32))
+    // # '0b11111111111111111111111111111110_00000000000000000000000000000001'
+    //
+    // print(int_bin(p01 & mask, min_groups=2, group_size=32))
+    // # '0b00000000000000000000000000000000_00000000000000000000000000000001'
+    //
+    // print(int_bin(p00 >> bits, min_groups=2, group_size=32))
+    // # '0b00000000000000000000000000000000_11111111111111111111111111111110'
+    //
+    // print(int_bin(mid, min_groups=2, group_size=32))
+    // # '0b11111111111111111111111111111111_00000000000000000000000000000000'
+    // ```
+    mid = p10 + (p01 & mask) + (p00 >> 32);
+
+    // Upper 64 bits of the 64x64 128-bit product is in dst[128..64].
+    // We know that 64x64 multiplication cannot possibly overflow
+    // the 128-bits hence we do not check for it.
+    //
+    //  p11[64..00] - Goes into dst[128..64].
+    //  mid[64..32] - 96-bit product a*b0 that goes in dst[96..64].
+    //  p01[64..32] - The portion that goes in dst[96..64].
+    *hi = p11 + (mid >> 32) + (p01 >> 32);
+
+    // Lower 64-bits of the 64x64 128-bit product is in dst[64..00].
+    //
+    //  mid[32..00] - 96-bit product a*b0 that goes in dst[64..32].
+    //  p00[32..00] - p00[32:64] was already added to `mids`.
+    return (mid << 32) | (p00 & mask);
+#endif // MATH_CHECKED_INT128
+}
+
+#if !defined(MATH_CHECKED_DIVQ)
+
+/** @brief Number of leading zero bits in `a`, which must be nonzero. */
+static int
+internal_u64_leading_zeros(u64 a)
+{
+#if defined(MATH_CHECKED_BUILTINS)
+    return __builtin_clzll(a);
+#else // !MATH_CHECKED_BUILTINS
+    int n = 0;
+    while ((a & (cast(u64)1 << 63)) == 0) {
+        a <<= 1;
+        n  += 1;
+    }
+    return n;
+#endif // MATH_CHECKED_BUILTINS
+}
+
+#endif // MATH_CHECKED_DIVQ
+
+/** @link Hacker's Delight, 2nd ed., figure 9-3 (`divlu`). */
+u64
+u128_div_u64(u64 hi, u64 lo, u64 d, u64 *rem)
+{
+    assert(hi < d);
+
+#if defined(MATH_CHECKED_DIVQ)
+    u64 quot;
+
+    // `rdx:rax / d`, leaving the quotient in `rax` and remainder in `rdx`.
+    __asm__("divq %[d]" : "=a"(quot), "=d"(*rem) : [d] "rm"(d), "a"(lo), "d"(hi));
+    return quot;
+#else // !MATH_CHECKED_DIVQ
+    // Long division of 4 32-bit digits by 2, using the native 64/64
+    // division to estimate each quotient digit from the top 2 digits.
+    const u64 base = cast(u64)1 << 32;
+    const u64 mask = U32_MAX;
+    u64 d1, d0, n32, n21, n10, n1, n0, q1, q0, rhat;
+    int shift;
+
+    // Normalize so that the top bit of `d` is set, which makes each estimate
+    // at most 2 too large. `hi < d` means nothing is shifted out of `hi`.
+    shift = internal_u64_leading_zeros(d);
+    d   <<= shift;
+    d1    = d >> 32;
+    d0    = d & mask;
+    n32   = (shift == 0) ? hi : (hi << shift) | (lo >> (64 - shift));
+    n10   = lo << shift;
+    n1    = n10 >> 32;
+    n0    = n10 & mask;
+
+    // Upper quotient digit: `n32:n1 / d`.
+    q1   = n32 / d1;
+    rhat = n32 - q1 * d1;
+    while (q1 >= base || q1 * d0 > base * rhat + n1) {
+        q1   -= 1;
+        rhat += d1;
+        if (rhat >= base) {
+            break;
+        }
+    }
+
+    // Lower quotient digit: `n21:n0 / d`. Both wrap around, but the true
+    // partial remainder fits in 64 bits.
+    n21  = n32 * base + n1 - q1 * d;
+    q0   = n21 / d1;
+    rhat = n21 - q0 * d1;
+    while (q0 >= base || q0 * d0 > base * rhat + n0) {
+        q0   -= 1;
+        rhat += d1;
+        if (rhat >= base) {
+            break;
+        }
+    }
+
+    // Undo the normalization on the remainder only.
+    *rem = (n21 * base + n0 - q0 * d) >> shift;
+    return q1 * base + q0;
+#endif // MATH_CHECKED_DIVQ
 }
@@ -107,9 +107,81 @@ i64_checked_sub_carry(i64 *dst, i64 a, i64 b, i64 carry);
  * @param [out] dst Always assigned no matter what.
  *
  * @return
- *  `true` if the multiplication resulted in unsigned overflow else false`.
+ *  `true` if the multiplication resulted in unsigned overflow else `false`.
  */
 bool
 u64_checked_mul(u64 *dst, u64 a, u64 b);
 
+
+/** @brief `*dst = a * b` with an overflow check for
+ *  `a * b < min(i64) or a * b > max(i64)`.
+ *
+ * @param [out] dst Always assigned no matter what.
+ *
+ * @return
+ *  `true` if the multiplication resulted in signed overflow else `false`.
+ */
+bool
+i64_checked_mul(i64 *dst, i64 a, i64 b);
+
+
+/** @brief `a + b`, clamped to `max(u64)` instead of wrapping around. */
+u64
+u64_saturating_add(u64 a, u64 b);
+
+
+/** @brief `a - b`, clamped to 0 instead of wrapping around. */
+u64
+u64_saturating_sub(u64 a, u64 b);
+
+
+/** @brief `a * b`, clamped to `max(u64)` instead of wrapping around. */
+u64
+u64_saturating_mul(u64 a, u64 b);
+
+
+/** @brief `a + b`, clamped to `min(i64)` or `max(i64)` instead of wrapping
+ *  around. */
+i64
+i64_saturating_add(i64 a, i64 b);
+
+
+/** @brief `a - b`, clamped to `min(i64)` or `max(i64)` instead of wrapping
+ *  around. */
+i64
+i64_saturating_sub(i64 a, i64 b);
+
+
+/** @brief `a * b`, clamped to `min(i64)` or `max(i64)` instead of wrapping
+ *  around. */
+i64
+i64_saturating_mul(i64 a, i64 b);
+
+
+/** @brief The full 128-bit product of `a * b`, which can never overflow.
+ *
+ * @param [out] hi  The upper 64 bits of the product.
+ *
+ * @return
+ *  The lower 64 bits of the product.
+ */
+u64
+u64_mul_wide(u64 a, u64 b, u64 *hi);
+
+
+/** @brief Divide the 128-bit number `hi:lo` by `d`.
+ *
+ * @param [out] rem The remainder, always less than `d`.
+ *
+ * @return
+ *  The quotient.
+ *
+ * @warning
+ *  `hi < d` is required, so that `d` is nonzero and the quotient fits in 64
+ *  bits. Multi-limb division maintains this by dividing the running
+ *  remainder, which is always less than `d`, with the next limb.
+ */
+u64
+u128_div_u64(u64 hi, u64 lo, u64 d, u64 *rem);
+
 #endif // PROJECTS_MATH_CHECKED_H
@@ -0,0 +1,149 @@
+#include "limbs.h"
+
+// Needs checked.c in the same translation unit, so that the carry helpers
+// can be inlined into the loops below and compile to `adc`/`sbb` chains.
+
+// Limbs per iteration of the main loops. Incrementing and comparing the loop
+// counter clobbers the carry flag, so the compiler has to save and restore
+// it once per iteration rather than once per limb.
+#define LIMBS_UNROLL    4
+
+
+u64
+limbs_add_n(u64 *dst, const u64 *a, const u64 *b, size_t n)
+{
+    bool carry = false;
+    size_t i   = 0;
+
+    for (; i + LIMBS_UNROLL <= n; i += LIMBS_UNROLL) {
+        carry = u64_checked_add_carry(&dst[i + 0], a[i + 0], b[i + 0], carry);
+        carry = u64_checked_add_carry(&dst[i + 1], a[i + 1], b[i + 1], carry);
+        carry = u64_checked_add_carry(&dst[i + 2], a[i + 2], b[i + 2], carry);
+        carry = u64_checked_add_carry(&dst[i + 3], a[i + 3], b[i + 3], carry);
+    }
+    for (; i < n; i += 1) {
+        carry = u64_checked_add_carry(&dst[i], a[i], b[i], carry);
+    }
+    return carry;
+}
+
+u64
+limbs_sub_n(u64 *dst, const u64 *a, const u64 *b, size_t n)
+{
+    bool borrow = false;
+    size_t i    = 0;
+
+    for (; i + LIMBS_UNROLL <= n; i += LIMBS_UNROLL) {
+        borrow = u64_checked_sub_carry(&dst[i + 0], a[i + 0], b[i + 0], borrow);
+        borrow = u64_checked_sub_carry(&dst[i + 1], a[i + 1], b[i + 1], borrow);
+        borrow = u64_checked_sub_carry(&dst[i + 2], a[i + 2], b[i + 2], borrow);
+        borrow = u64_checked_sub_carry(&dst[i + 3], a[i + 3], b[i + 3], borrow);
+    }
+    for (; i < n; i += 1) {
+        borrow = u64_checked_sub_carry(&dst[i], a[i], b[i], borrow);
+    }
+    return borrow;
+}
+
+// In the steps below, `carry` is a whole limb rather than a single bit. The
+// high limb of a product is at most `2^64 - 2`, so adding the carries out of
+// the two additions to it never overflows.
+
+static u64
+internal_limbs_mul_step(u64 *dst, u64 a, u64 b, u64 carry)
+{
+    u64 hi, lo;
+
+    lo  = u64_mul_wide(a, b, &hi);
+    hi += u64_checked_add(dst, lo, carry);
+    return hi;
+}
+
+static u64
+internal_limbs_addmul_step(u64 *dst, u64 a, u64 b, u64 carry)
+{
+    u64 hi, lo;
+
+    lo  = u64_mul_wide(a, b, &hi);
+    hi += u64_checked_add(&lo, lo, carry);
+    hi += u64_checked_add(dst, *dst, lo);
+    return hi;
+}
+
+static u64
+internal_limbs_submul_step(u64 *dst, u64 a, u64 b, u64 carry)
+{
+    u64 hi, lo;
+
+    lo  = u64_mul_wide(a, b, &hi);
+    hi += u64_checked_add(&lo, lo, carry);
+    hi += u64_checked_sub(dst, *dst, lo);
+    return hi;
+}
+
+u64
+limbs_mul_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 carry = 0;
+    size_t i  = 0;
+
+    for (; i + LIMBS_UNROLL <= n; i += LIMBS_UNROLL) {
+        carry = internal_limbs_mul_step(&dst[i + 0], a[i + 0], b, carry);
+        carry = internal_limbs_mul_step(&dst[i + 1], a[i + 1], b, carry);
+        carry = internal_limbs_mul_step(&dst[i + 2], a[i + 2], b, carry);
+        carry = internal_limbs_mul_step(&dst[i + 3], a[i + 3], b, carry);
+    }
+    for (; i < n; i += 1) {
+        carry = internal_limbs_mul_step(&dst[i], a[i], b, carry);
+    }
+    return carry;
+}
+
+u64
+limbs_addmul_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 carry = 0;
+    size_t i  = 0;
+
+    for (; i + LIMBS_UNROLL <= n; i += LIMBS_UNROLL) {
+        carry = internal_limbs_addmul_step(&dst[i + 0], a[i + 0], b, carry);
+        carry = internal_limbs_addmul_step(&dst[i + 1], a[i + 1], b, carry);
+        carry = internal_limbs_addmul_step(&dst[i + 2], a[i + 2], b, carry);
+        carry = internal_limbs_addmul_step(&dst[i + 3], a[i + 3], b, carry);
+    }
+    for (; i < n; i += 1) {
+        carry = internal_limbs_addmul_step(&dst[i], a[i], b, carry);
+    }
+    return carry;
+}
+
+u64
+limbs_submul_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 carry = 0;
+    size_t i  = 0;
+
+    for (; i + LIMBS_UNROLL <= n; i += LIMBS_UNROLL) {
+        carry = internal_limbs_submul_step(&dst[i + 0], a[i + 0], b, carry);
+        carry = internal_limbs_submul_step(&dst[i + 1], a[i + 1], b, carry);
+        carry = internal_limbs_submul_step(&dst[i + 2], a[i + 2], b, carry);
+        carry = internal_limbs_submul_step(&dst[i + 3], a[i + 3], b, carry);
+    }
+    for (; i < n; i += 1) {
+        carry = internal_limbs_submul_step(&dst[i], a[i], b, carry);
+    }
+    return carry;
+}
+
+u64
+limbs_divrem_1(u64 *dst, const u64 *a, size_t n, u64 b)
+{
+    u64 rem = 0;
+
+    // Schoolbook division from the most significant limb down. The running
+    // remainder is less than `b`, as `u128_div_u64` requires.
+    for (size_t i = n; i > 0; i -= 1) {
+        dst[i - 1] = u128_div_u64(rem, a[i - 1], b, &rem);
+    }
+    return rem;
+}
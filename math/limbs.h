@@ -0,0 +1,64 @@
+#ifndef PROJECTS_MATH_LIMBS_H
+#define PROJECTS_MATH_LIMBS_H
+
+#include "checked.h"
+
+/**
+ * @brief Kernels over little-endian arrays of `u64` limbs, in the style of
+ *  GMP's `mpn` layer: least significant limb first, no sign, no allocation.
+ *
+ * @note
+ *  `dst` may be the same array as `a` (or `b`), but must not otherwise
+ *  overlap either. `n` may be 0, in which case nothing is written.
+ */
+
+
+/** @brief `dst[:n] = a[:n] + b[:n]`.
+ *
+ * @return The carry out of the most significant limb, 0 or 1.
+ */
+u64
+limbs_add_n(u64 *dst, const u64 *a, const u64 *b, size_t n);
+
+
+/** @brief `dst[:n] = a[:n] - b[:n]`, wrapping around if `a < b`.
+ *
+ * @return The borrow out of the most significant limb, 0 or 1.
+ */
+u64
+limbs_sub_n(u64 *dst, const u64 *a, const u64 *b, size_t n);
+
+
+/** @brief `dst[:n] = a[:n] * b`.
+ *
+ * @return The limb that did not fit, i.e. `dst[n]` of the full product.
+ */
+u64
+limbs_mul_1(u64 *dst, const u64 *a, size_t n, u64 b);
+
+
+/** @brief `dst[:n] += a[:n] * b`, the inner step of schoolbook
+ *  multiplication.
+ *
+ * @return The limb that did not fit, to be added at `dst[n]`.
+ */
+u64
+limbs_addmul_1(u64 *dst, const u64 *a, size_t n, u64 b);
+
+
+/** @brief `dst[:n] -= a[:n] * b`, the inner step of schoolbook division.
+ *
+ * @return The limb still to be subtracted at `dst[n]`.
+ */
+u64
+limbs_submul_1(u64 *dst, const u64 *a, size_t n, u64 b);
+
+
+/** @brief `dst[:n] = a[:n] / b`, where `b` must be nonzero.
+ *
+ * @return The remainder, `a[:n] % b`.
+ */
+u64
+limbs_divrem_1(u64 *dst, const u64 *a, size_t n, u64 b);
+
+#endif // PROJECTS_MATH_LIMBS_H
@@ -1,76 +1,171 @@
 #include "allocator.h"
 
 void *
-mem_alloc(size_t size, Allocator allocator)
+mem_alloc_loc(size_t size,
+    Allocator allocator,
+    const char *location)
 {
     return allocator.fn(allocator.context,
         /*mode=      */ ALLOCATOR_ALLOC,
         /*old_memory=*/ NULL,
         /*old_size=  */ 0,
         /*new_size=  */ size,
-        /*align=     */ MEM_DEFAULT_ALIGNMENT);
+        /*align=     */ MEM_DEFAULT_ALIGNMENT,
+        /*location=  */ location);
 }
 
 void *
-mem_resize(void *old_memory,
+mem_resize_loc(void *old_memory,
     size_t old_size,
     size_t new_size,
-    Allocator allocator)
+    Allocator allocator,
+    const char *location)
 {
     return allocator.fn(allocator.context,
         ALLOCATOR_RESIZE,
         old_memory,
         old_size,
         new_size,
-        MEM_DEFAULT_ALIGNMENT);
+        MEM_DEFAULT_ALIGNMENT,
+        location);
 }
 
 void *
-mem_alloc_align(size_t size, size_t align, Allocator allocator)
+mem_alloc_align_loc(size_t size,
+    size_t align,
+    Allocator allocator,
+    const char *location)
 {
     return allocator.fn(allocator.context,
         /*mode=      */ ALLOCATOR_ALLOC,
         /*old_memory=*/ NULL,
         /*old_size=  */ 0,
         /*new_size=  */ size,
-        /*align=     */ align);
+        /*align=     */ align,
+        /*location=  */ location);
 }
 
 void *
-mem_resize_align(void *old_memory,
+mem_resize_align_loc(void *old_memory,
     size_t old_size,
     size_t new_size,
     size_t align,
-    Allocator allocator)
+    Allocator allocator,
+    const char *location)
 {
     return allocator.fn(allocator.context,
         ALLOCATOR_RESIZE,
         old_memory,
         old_size,
         new_size,
-        align);
+        align,
+        location);
+}
+
+void *
+mem_alloc_non_zeroed_loc(size_t size,
+    Allocator allocator,
+    const char *location)
+{
+    return allocator.fn(allocator.context,
+        /*mode=      */ ALLOCATOR_ALLOC_NON_ZEROED,
+        /*old_memory=*/ NULL,
+        /*old_size=  */ 0,
+        /*new_size=  */ size,
+        /*align=     */ MEM_DEFAULT_ALIGNMENT,
+        /*location=  */ location);
+}
+
+void *
+mem_resize_non_zeroed_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    Allocator allocator,
+    const char *location)
+{
+    return allocator.fn(allocator.context,
+        ALLOCATOR_RESIZE_NON_ZEROED,
+        old_memory,
+        old_size,
+        new_size,
+        MEM_DEFAULT_ALIGNMENT,
+        location);
+}
+
+void *
+mem_alloc_align_non_zeroed_loc(size_t size,
+    size_t align,
+    Allocator allocator,
+    const char *location)
+{
+    return allocator.fn(allocator.context,
+        /*mode=      */ ALLOCATOR_ALLOC_NON_ZEROED,
+        /*old_memory=*/ NULL,
+        /*old_size=  */ 0,
+        /*new_size=  */ size,
+        /*align=     */ align,
+        /*location=  */ location);
+}
+
+void *
+mem_resize_align_non_zeroed_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    size_t align,
+    Allocator allocator,
+    const char *location)
+{
+    return allocator.fn(allocator.context,
+        ALLOCATOR_RESIZE_NON_ZEROED,
+        old_memory,
+        old_size,
+        new_size,
+        align,
+        location);
+}
+
+bool
+mem_try_resize_in_place_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    Allocator allocator,
+    const char *location)
+{
+    void *ptr = allocator.fn(allocator.context,
+        /*mode=      */ ALLOCATOR_TRY_RESIZE_IN_PLACE,
+        /*old_memory=*/ old_memory,
+        /*old_size=  */ old_size,
+        /*new_size=  */ new_size,
+        /*align=     */ 0,
+        /*location=  */ location);
+    return old_memory != NULL && ptr == old_memory;
 }
 
 void
-mem_free(void *memory, size_t size, Allocator allocator)
+mem_free_loc(void *memory,
+    size_t size,
+    Allocator allocator,
+    const char *location)
 {
     allocator.fn(allocator.context,
         /*mode=      */ ALLOCATOR_FREE,
         /*old_memory=*/ memory,
         /*old_size=  */ size,
         /*new_size=  */ 0,
-        /*align=     */ 0);
+        /*align=     */ 0,
+        /*location=  */ location);
 }
 
 void
-mem_free_all(Allocator allocator)
+mem_free_all_loc(Allocator allocator, const char *location)
 {
     allocator.fn(allocator.context,
         /*mode=      */ ALLOCATOR_FREE_ALL,
         /*old_memory=*/ NULL,
         /*old_size=  */ 0,
         /*new_size=  */ 0,
-        /*align=     */ 0);
+        /*align=     */ 0,
+        /*location=  */ location);
 }
 
 bool
@@ -78,3 +173,22 @@ mem_is_power_of_two(uintptr_t x)
 {
     return (x & (x - 1)) == 0;
 }
+
+uintptr_t
+mem_align_forward(uintptr_t ptr, size_t align)
+{
+    uintptr_t modulo;
+
+    // Required for modulo via bit-and to work.
+    assert(mem_is_power_of_two(align));
+
+    // Same as `p % a` but faster when `a` is a power of 2.
+    modulo = ptr & (align - 1);
+
+    // Address is not aligned?
+    if (modulo != 0) {
+        // `p` is not yet aligned, push it to the next aligned address.
+        ptr += align - modulo;
+    }
+    return ptr;
+}
@@ -12,6 +12,16 @@ typedef enum {
     ALLOCATOR_RESIZE,
     ALLOCATOR_FREE,
     ALLOCATOR_FREE_ALL,
+
+    // Same as `ALLOCATOR_ALLOC` and `ALLOCATOR_RESIZE`, but new memory is left
+    // uninitialized. Useful when the caller overwrites it right away anyway.
+    ALLOCATOR_ALLOC_NON_ZEROED,
+    ALLOCATOR_RESIZE_NON_ZEROED,
+
+    // Resize `old_memory` only if it can be done without moving it. Returns
+    // `old_memory` on success, else `NULL` and the block is left untouched.
+    // The growth region, if any, is left uninitialized.
+    ALLOCATOR_TRY_RESIZE_IN_PLACE,
 } Allocator_Mode;
 
 typedef void *
@@ -20,7 +30,11 @@ typedef void *
     void *old_memory,
     size_t old_size,
     size_t new_size,
-    size_t align);
+    size_t align,
+
+    // Call site of the request as given by `FILE_LINE_STRING`, or `NULL`.
+    // Only useful to allocators that record it, e.g. `Tracking_Allocator`.
+    const char *location);
 
 typedef struct Allocator Allocator;
 struct Allocator {
@@ -28,6 +42,46 @@ struct Allocator {
     void        *context;
 };
 
+// Each `mem_*` call records its call site for allocators that want it.
+// Call the `*_loc` functions directly to forward a caller's location instead.
+#define mem_alloc(size, allocator)                                             \
+    mem_alloc_loc(size, allocator, FILE_LINE_STRING)
+
+#define mem_resize(old_memory, old_size, new_size, allocator)                  \
+    mem_resize_loc(old_memory, old_size, new_size, allocator, FILE_LINE_STRING)
+
+#define mem_alloc_align(size, align, allocator)                                \
+    mem_alloc_align_loc(size, align, allocator, FILE_LINE_STRING)
+
+#define mem_resize_align(old_memory, old_size, new_size, align, allocator)     \
+    mem_resize_align_loc(old_memory, old_size, new_size, align, allocator,     \
+        FILE_LINE_STRING)
+
+#define mem_alloc_non_zeroed(size, allocator)                                  \
+    mem_alloc_non_zeroed_loc(size, allocator, FILE_LINE_STRING)
+
+#define mem_resize_non_zeroed(old_memory, old_size, new_size, allocator)       \
+    mem_resize_non_zeroed_loc(old_memory, old_size, new_size, allocator,       \
+        FILE_LINE_STRING)
+
+#define mem_alloc_align_non_zeroed(size, align, allocator)                     \
+    mem_alloc_align_non_zeroed_loc(size, align, allocator, FILE_LINE_STRING)
+
+#define mem_resize_align_non_zeroed(old_memory, old_size, new_size, align,     \
+    allocator)                                                                 \
+    mem_resize_align_non_zeroed_loc(old_memory, old_size, new_size, align,     \
+        allocator, FILE_LINE_STRING)
+
+#define mem_try_resize_in_place(old_memory, old_size, new_size, allocator)    \
+    mem_try_resize_in_place_loc(old_memory, old_size, new_size, allocator,     \
+        FILE_LINE_STRING)
+
+#define mem_free(memory, size, allocator)                                      \
+    mem_free_loc(memory, size, allocator, FILE_LINE_STRING)
+
+#define mem_free_all(allocator)                                                \
+    mem_free_all_loc(allocator, FILE_LINE_STRING)
+
 #define array_make(T, count, allocator)                                        \
     (T *)mem_alloc_align(sizeof(T) * (count),                                  \
         /*align=*/       alignof(T),                                           \
@@ -40,6 +94,24 @@ struct Allocator {
         /*align=*/        alignof(T),                                          \
         /*allocator=*/    allocator)
 
+#define array_make_non_zeroed(T, count, allocator)                             \
+    (T *)mem_alloc_align_non_zeroed(sizeof(T) * (count),                       \
+        /*align=*/       alignof(T),                                           \
+        /*allocator=*/   allocator)
+
+#define array_resize_non_zeroed(T, ptr, old_len, new_len, allocator)           \
+    array_resize_non_zeroed_loc(T, ptr, old_len, new_len, allocator,           \
+        FILE_LINE_STRING)
+
+#define array_resize_non_zeroed_loc(T, ptr, old_len, new_len, allocator,       \
+    location)                                                                  \
+    (T *)mem_resize_align_non_zeroed_loc(ptr,                                  \
+        /*old_size=*/     sizeof(T) * (old_len),                               \
+        /*new_size=*/     sizeof(T) * (new_len),                               \
+        /*align=*/        alignof(T),                                          \
+        /*allocator=*/    allocator,                                           \
+        /*location=*/     location)
+
 #define array_delete(ptr, len, allocator)                                      \
     mem_free(/*memory=*/ptr,                                                   \
         /*size=*/       sizeof(*(ptr)) * (len),                                \
@@ -49,43 +121,113 @@ struct Allocator {
 /** @brief Allocate `size` bytes using the default alignment.
  *  The resulting memory block is fully intialized to zero. */
 void *
-mem_alloc(size_t size, Allocator allocator);
+mem_alloc_loc(size_t size,
+    Allocator allocator,
+    const char *location);
 
 
 /** @brief Reallocate `old_memory` from `old_size` bytes to `new_size` bytes,
  *  using the default alignment. The new region, if growing, is fully
  *  initialized to zero. */
 void *
-mem_resize(void *old_memory,
+mem_resize_loc(void *old_memory,
     size_t old_size,
     size_t new_size,
-    Allocator allocator);
+    Allocator allocator,
+    const char *location);
 
 
 /** @brief Allocate `size` bytes using the given alignment `align`.
  *  The resulting memory block is fully initialized to zero. */
 void *
-mem_alloc_align(size_t size, size_t align, Allocator allocator);
+mem_alloc_align_loc(size_t size,
+    size_t align,
+    Allocator allocator,
+    const char *location);
 
 
 /** @brief Reallocate `old_memory` from `old_size` bytes to `new_size` bytes,
  *  using the given alignment `align`. The new memory region, if growing,
  *  is fully initialized to zero. */
 void *
-mem_resize_align(void *old_memory,
+mem_resize_align_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    size_t align,
+    Allocator allocator,
+    const char *location);
+
+
+/** @brief Allocate `size` bytes using the default alignment.
+ *  The contents of the resulting memory block are unspecified. */
+void *
+mem_alloc_non_zeroed_loc(size_t size,
+    Allocator allocator,
+    const char *location);
+
+
+/** @brief Reallocate `old_memory` from `old_size` bytes to `new_size` bytes,
+ *  using the default alignment. The new region, if growing, is left
+ *  uninitialized. */
+void *
+mem_resize_non_zeroed_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    Allocator allocator,
+    const char *location);
+
+
+/** @brief Allocate `size` bytes using the given alignment `align`.
+ *  The contents of the resulting memory block are unspecified. */
+void *
+mem_alloc_align_non_zeroed_loc(size_t size,
+    size_t align,
+    Allocator allocator,
+    const char *location);
+
+
+/** @brief Reallocate `old_memory` from `old_size` bytes to `new_size` bytes,
+ *  using the given alignment `align`. The new memory region, if growing,
+ *  is left uninitialized. */
+void *
+mem_resize_align_non_zeroed_loc(void *old_memory,
     size_t old_size,
     size_t new_size,
     size_t align,
-    Allocator allocator);
+    Allocator allocator,
+    const char *location);
+
+/** @brief Ask `allocator` to resize `old_memory` without moving it, e.g. to
+ *  prefer growing a buffer to an exact fit over copying it elsewhere.
+ *
+ * @return `true` if `old_memory` now holds `new_size` bytes, of which the
+ *  growth region is left uninitialized. `false` if it would have to move,
+ *  leaving it untouched.
+ */
+bool
+mem_try_resize_in_place_loc(void *old_memory,
+    size_t old_size,
+    size_t new_size,
+    Allocator allocator,
+    const char *location);
 
 void
-mem_free(void *memory, size_t size, Allocator allocator);
+mem_free_loc(void *memory,
+    size_t size,
+    Allocator allocator,
+    const char *location);
 
 void
-mem_free_all(Allocator allocator);
+mem_free_all_loc(Allocator allocator, const char *location);
 
 // Useful for alignment.
 bool
 mem_is_power_of_two(uintptr_t x);
 
+
+/** @brief Round `ptr` up to the next multiple of `align`, which must be a
+ *  power of 2. */
+uintptr_t
+mem_align_forward(uintptr_t ptr, size_t align);
+
 #endif /* MEM_ALLOCATOR_H */
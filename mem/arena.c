@@ -1,24 +1,5 @@
 #include "arena.h"
 
-static uintptr_t
-align_forward(uintptr_t ptr, size_t align)
-{
-    uintptr_t modulo;
-
-    // Required for modulo via bit-and to work.
-    assert(mem_is_power_of_two(align));
-
-    // Same as `p % a` but faster when `a` is a power of 2.
-    modulo = ptr & (align - 1);
-
-    // Address is not aligned?
-    if (modulo != 0) {
-        // `p` is not yet aligned, push it to the next aligned address.
-        ptr += align - modulo;
-    }
-    return ptr;
-}
-
 void
 arena_init(Arena *a, void *backing_buffer, size_t backing_buffer_length)
 {
@@ -36,12 +17,23 @@ arena_alloc(Arena *a, size_t size)
 
 void *
 arena_alloc_align(Arena *a, size_t size, size_t align)
+{
+    void *ptr = arena_alloc_align_non_zeroed(a, size, align);
+    // Zero new memory by default
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+arena_alloc_align_non_zeroed(Arena *a, size_t size, size_t align)
 {
     // Get the first immediately available pointer.
     uintptr_t curr_ptr = cast(uintptr_t)a->buf + cast(uintptr_t)a->curr_offset;
 
     // Align the aforementioned address forward to the specified alignment.
-    uintptr_t offset = align_forward(curr_ptr, align);
+    uintptr_t offset = mem_align_forward(curr_ptr, align);
 
     // Convert said offset from an absolute offset into a relative one.
     offset -= cast(uintptr_t)a->buf;
@@ -51,8 +43,7 @@ arena_alloc_align(Arena *a, size_t size, size_t align)
         void *ptr      = &a->buf[offset];
         a->prev_offset = offset;
         a->curr_offset = offset + size;
-        // Zero new memory by default
-        return memset(ptr, 0, size);
+        return ptr;
     }
     // Out of memory!
     return NULL;
@@ -71,41 +62,71 @@ arena_resize_align(Arena *a,
     size_t old_size,
     size_t new_size,
     size_t align)
+{
+    unsigned char *new_addr;
+
+    new_addr = arena_resize_align_non_zeroed(a, old_ptr, old_size, new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_addr != NULL && old_size < new_size) {
+        memset(new_addr + old_size, 0, new_size - old_size);
+    }
+    return new_addr;
+}
+
+void *
+arena_resize_align_non_zeroed(Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
 {
     unsigned char *old_addr = cast(unsigned char *)old_ptr;
     assert(mem_is_power_of_two(align));
 
     // Requesting for a new block?
     if (old_addr == NULL || (old_size == 0 && new_size > 0)) {
-        return arena_alloc_align(a, new_size, align);
+        return arena_alloc_align_non_zeroed(a, new_size, align);
     // Resizing an existing block?
     } else if (a->buf <= old_addr && old_addr < a->buf + a->buf_len) {
-        // `old_mem` is exactly the last allocation?
-        // This means it can be resized in-place.
-        if (a->buf + a->prev_offset == old_addr) {
-            // Growing the allocation?
-            if (old_size < new_size) {
-                size_t growth = new_size - old_size;
-                memset(&a->buf[a->curr_offset], 0, growth);
-                a->curr_offset += growth;
-            }
-            else {
-                a->curr_offset -= old_size - new_size;
-            }
+        void *new_ptr;
+        size_t copy_size;
+
+        if (arena_try_resize_in_place(a, old_ptr, old_size, new_size)) {
             return old_ptr;
         }
-        // `old_mem` is NOT exactly the last allocation.
-        else {
-            void *new_ptr = arena_alloc_align(a, new_size, align);
-            size_t copy_size = (old_size < new_size) ? old_size : new_size;
-            return memmove(new_ptr, old_ptr, copy_size);
+
+        new_ptr = arena_alloc_align_non_zeroed(a, new_size, align);
+        if (new_ptr == NULL) {
+            return NULL;
         }
+        copy_size = (old_size < new_size) ? old_size : new_size;
+        return memmove(new_ptr, old_ptr, copy_size);
     } else {
         assert(0 && "Memory is out of bounds of the buffer in this arena");
         return NULL;
     }
 }
 
+bool
+arena_try_resize_in_place(Arena *a, void *old_ptr, size_t old_size, size_t new_size)
+{
+    unsigned char *old_addr = cast(unsigned char *)old_ptr;
+
+    // `old_ptr` is exactly the last allocation? Then only the end of the
+    // buffer limits it.
+    if (old_addr != NULL && a->buf + a->prev_offset == old_addr) {
+        if (new_size > a->buf_len - a->prev_offset) {
+            return false;
+        }
+        a->curr_offset = a->prev_offset + new_size;
+        return true;
+    }
+
+    // Any other block may shrink, but its trailing bytes are lost until the
+    // next free all.
+    return old_addr != NULL && new_size <= old_size;
+}
+
 void
 arena_free_all(Arena *a)
 {
@@ -119,9 +140,11 @@ arena_allocator_fn(void *context,
     void          *old_ptr,
     size_t         old_size,
     size_t         new_size,
-    size_t         align)
+    size_t         align,
+    const char    *location)
 {
     Arena *a = cast(Arena *)context;
+    unused(location);
     switch (mode) {
     case ALLOCATOR_ALLOC:
         return arena_alloc_align(a, new_size, align);
@@ -132,6 +155,15 @@ arena_allocator_fn(void *context,
     case ALLOCATOR_FREE_ALL:
         arena_free_all(a);
         break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return arena_alloc_align_non_zeroed(a, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return arena_resize_align_non_zeroed(a, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (arena_try_resize_in_place(a, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
     }
     return NULL;
 }
@@ -142,3 +174,22 @@ arena_allocator(Arena *a)
     Allocator r = {arena_allocator_fn, a};
     return r;
 }
+
+Temp_Arena_Memory
+temp_arena_memory_begin(Arena *a)
+{
+    Temp_Arena_Memory temp;
+    temp.arena       = a;
+    temp.prev_offset = a->prev_offset;
+    temp.curr_offset = a->curr_offset;
+    return temp;
+}
+
+void
+temp_arena_memory_end(Temp_Arena_Memory temp)
+{
+    // An inner scope was not ended, or the arena was freed in between?
+    assert(temp.curr_offset <= temp.arena->curr_offset);
+    temp.arena->prev_offset = temp.prev_offset;
+    temp.arena->curr_offset = temp.curr_offset;
+}
@@ -31,6 +31,11 @@ arena_alloc(Arena *a, size_t size);
 void *
 arena_alloc_align(Arena *a, size_t size, size_t align);
 
+
+/** @brief Like `arena_alloc_align`, but the memory is not zeroed. */
+void *
+arena_alloc_align_non_zeroed(Arena *a, size_t size, size_t align);
+
 void *
 arena_resize(Arena *a, void *old_memory, size_t old_size, size_t new_size);
 
@@ -41,10 +46,48 @@ arena_resize_align(Arena *a,
     size_t                new_size,
     size_t                align);
 
+
+/** @brief Like `arena_resize_align`, but the growth region is not zeroed. */
+void *
+arena_resize_align_non_zeroed(Arena *a,
+    void                              *old_memory,
+    size_t                             old_size,
+    size_t                             new_size,
+    size_t                             align);
+
+/** @brief Resize `old_ptr` without moving it, which only the most recent
+ *  allocation can grow.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+arena_try_resize_in_place(Arena *a, void *old_ptr, size_t old_size, size_t new_size);
+
 void
 arena_free_all(Arena *a);
 
 Allocator
 arena_allocator(Arena *a);
 
+// Savepoint of an `Arena`; everything allocated after it can be dropped
+// at once while keeping whatever was allocated before it.
+typedef struct Temp_Arena_Memory Temp_Arena_Memory;
+struct Temp_Arena_Memory {
+    Arena *arena;
+    size_t prev_offset;
+    size_t curr_offset;
+};
+
+
+/** @brief Save the current offsets of `a`. Scopes may be nested, but must be
+ *  ended in the reverse order that they were begun. */
+Temp_Arena_Memory
+temp_arena_memory_begin(Arena *a);
+
+
+/** @brief Restore the offsets saved by `temp_arena_memory_begin`, freeing
+ *  everything allocated in between. */
+void
+temp_arena_memory_end(Temp_Arena_Memory temp);
+
 #endif // MEM_ARENA_H
@@ -0,0 +1,180 @@
+#include <string.h> // memset, memcpy
+
+#include "atomic_arena.h"
+
+void
+atomic_arena_init(Atomic_Arena *a, void *backing_buffer, size_t backing_buffer_length)
+{
+    a->buf     = cast(unsigned char *)backing_buffer;
+    a->buf_len = backing_buffer_length;
+    atomic_init(&a->curr_offset, 0);
+}
+
+void *
+atomic_arena_alloc(Atomic_Arena *a, size_t size)
+{
+    return atomic_arena_alloc_align(a, size, MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+atomic_arena_alloc_align(Atomic_Arena *a, size_t size, size_t align)
+{
+    void *ptr = atomic_arena_alloc_align_non_zeroed(a, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+atomic_arena_alloc_align_non_zeroed(Atomic_Arena *a, size_t size, size_t align)
+{
+    size_t curr_offset, offset;
+
+    // A plain `fetch_add` cannot account for alignment padding, which depends
+    // on where the previous allocation ended. So we claim our range with
+    // compare-and-swap, retrying if another thread got there first.
+    //
+    // The offset itself publishes no data (each thread only touches its own
+    // range), so relaxed ordering is enough.
+    curr_offset = atomic_load_explicit(&a->curr_offset, memory_order_relaxed);
+    do {
+        uintptr_t curr_ptr = cast(uintptr_t)a->buf + cast(uintptr_t)curr_offset;
+
+        offset = cast(size_t)(mem_align_forward(curr_ptr, align) - cast(uintptr_t)a->buf);
+        if (offset > a->buf_len || size > a->buf_len - offset) {
+            // Out of memory!
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&a->curr_offset,
+        &curr_offset, offset + size, memory_order_relaxed, memory_order_relaxed));
+
+    return &a->buf[offset];
+}
+
+void *
+atomic_arena_resize_align(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *new_addr;
+
+    new_addr = atomic_arena_resize_align_non_zeroed(a, old_ptr, old_size,
+        new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_addr != NULL && old_size < new_size) {
+        memset(new_addr + old_size, 0, new_size - old_size);
+    }
+    return new_addr;
+}
+
+void *
+atomic_arena_resize_align_non_zeroed(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *old_addr = cast(unsigned char *)old_ptr;
+    void *new_ptr;
+    size_t copy_size;
+
+    // Requesting for a new block?
+    if (old_addr == NULL || (old_size == 0 && new_size > 0)) {
+        return atomic_arena_alloc_align_non_zeroed(a, new_size, align);
+    } else if (!(a->buf <= old_addr && old_addr < a->buf + a->buf_len)) {
+        assert(0 && "Memory is out of bounds of the buffer in this arena");
+        return NULL;
+    }
+
+    if (atomic_arena_try_resize_in_place(a, old_ptr, old_size, new_size)) {
+        return old_ptr;
+    }
+
+    new_ptr = atomic_arena_alloc_align_non_zeroed(a, new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    copy_size = (old_size < new_size) ? old_size : new_size;
+    return memcpy(new_ptr, old_ptr, copy_size);
+}
+
+bool
+atomic_arena_try_resize_in_place(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size)
+{
+    unsigned char *old_addr = cast(unsigned char *)old_ptr;
+    size_t offset, expected;
+
+    if (!(a->buf <= old_addr && old_addr < a->buf + a->buf_len)) {
+        return false;
+    }
+
+    // `old_ptr` is exactly the last allocation? Then we can move the top
+    // in-place, unless another thread allocates in the meantime.
+    offset   = cast(size_t)(old_addr - a->buf);
+    expected = offset + old_size;
+    if (new_size <= a->buf_len - offset
+        && atomic_compare_exchange_strong_explicit(&a->curr_offset, &expected,
+            offset + new_size, memory_order_relaxed, memory_order_relaxed))
+    {
+        return true;
+    }
+
+    // Any other block may shrink, but its trailing bytes are lost until the
+    // next free all.
+    return new_size <= old_size;
+}
+
+void
+atomic_arena_free_all(Atomic_Arena *a)
+{
+    atomic_store_explicit(&a->curr_offset, 0, memory_order_relaxed);
+}
+
+static void *
+atomic_arena_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Atomic_Arena *a = cast(Atomic_Arena *)context;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return atomic_arena_alloc_align(a, new_size, align);
+    case ALLOCATOR_RESIZE:
+        return atomic_arena_resize_align(a, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_FREE:
+        // Individual frees are not supported, same as `Arena`.
+        break;
+    case ALLOCATOR_FREE_ALL:
+        atomic_arena_free_all(a);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return atomic_arena_alloc_align_non_zeroed(a, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return atomic_arena_resize_align_non_zeroed(a, old_ptr, old_size,
+            new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (atomic_arena_try_resize_in_place(a, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+atomic_arena_allocator(Atomic_Arena *a)
+{
+    Allocator r = {atomic_arena_allocator_fn, a};
+    return r;
+}
@@ -0,0 +1,77 @@
+#ifndef MEM_ATOMIC_ARENA_H
+#define MEM_ATOMIC_ARENA_H
+
+#include <stdatomic.h> // atomic_size_t
+
+#include "allocator.h"
+
+// An `Arena` that multiple threads may allocate from at the same time
+// without a mutex. Each allocation claims its range with a compare-and-swap
+// on `curr_offset`, so threads never receive overlapping memory.
+typedef struct Atomic_Arena Atomic_Arena;
+struct Atomic_Arena {
+    unsigned char *buf;
+
+    // Total of how many bytes can be held in `buf`.
+    size_t buf_len;
+
+    // Track the current 'top' byte index.
+    atomic_size_t curr_offset;
+};
+
+void
+atomic_arena_init(Atomic_Arena *a, void *backing_buffer, size_t backing_buffer_length);
+
+void *
+atomic_arena_alloc(Atomic_Arena *a, size_t size);
+
+void *
+atomic_arena_alloc_align(Atomic_Arena *a, size_t size, size_t align);
+
+
+/** @brief Like `atomic_arena_alloc_align`, but the memory is not zeroed. */
+void *
+atomic_arena_alloc_align_non_zeroed(Atomic_Arena *a, size_t size, size_t align);
+
+
+/** @brief Resize in-place if `old_ptr` is still the most recent allocation
+ *  made by any thread, else allocate anew and copy. */
+void *
+atomic_arena_resize_align(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+
+/** @brief Like `atomic_arena_resize_align`, but the growth region is not
+ *  zeroed. */
+void *
+atomic_arena_resize_align_non_zeroed(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+
+/** @brief Resize `old_ptr` without moving it, which only the most recent
+ *  allocation made by any thread can grow.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+atomic_arena_try_resize_in_place(Atomic_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size);
+
+
+/** @brief Same semantics as `arena_free_all`. Not safe to call while other
+ *  threads may still be allocating, e.g. call it after joining them. */
+void
+atomic_arena_free_all(Atomic_Arena *a);
+
+Allocator
+atomic_arena_allocator(Atomic_Arena *a);
+
+#endif /* MEM_ATOMIC_ARENA_H */
@@ -0,0 +1,1000 @@
+// `mremap` and `MADV_HUGEPAGE` for page.c.
+#define _GNU_SOURCE
+
+#include <pthread.h> // pthread_create, pthread_join
+#include <stdio.h>   // printf
+#include <stdlib.h>  // qsort
+#include <string.h>  // memset
+
+#include <bench.h>
+
+#include "allocator.c"
+#include "arena.c"
+#include "atomic_arena.c"
+#include "free_list.c"
+#include "growing_arena.c"
+#include "heap.c"
+#include "page.c"
+#include "pool.c"
+#include "slab.c"
+#include "stack.c"
+#include "thread_cache.c"
+#include "trace.c"
+
+#define BENCH_ITERATIONS    2000
+#define BENCH_CHURN_SLOTS   1024
+#define BENCH_CHURN_ROUNDS  200000
+#define BENCH_THREAD_COUNT  8
+#define BENCH_THREAD_ALLOCS 20000
+#define BENCH_TRACE_OPS     200000
+#define BENCH_TRACE_BUFFER_SIZE (64 * 1024 * 1024)
+#define BENCH_LAYOUT_NODES  32768
+#define BENCH_LAYOUT_PASSES 20
+#define BENCH_HUGE_MIN      (1024 * 1024)
+#define BENCH_HUGE_MAX      (256 * 1024 * 1024)
+
+// Prevents the compiler from optimizing away our writes.
+static volatile unsigned char
+bench_sink;
+
+
+/** @brief Allocate and fill `size` bytes `BENCH_ITERATIONS` times, resetting
+ *  the allocator in between. Mimics callers that overwrite new memory right
+ *  away, e.g. `string_write_string`.
+ *
+ * @return Average nanoseconds per allocate-and-fill.
+ */
+static f64
+bench_alloc_fill(Allocator allocator, size_t size, bool zeroed)
+{
+    u64 start, stop;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_ITERATIONS; i += 1) {
+        unsigned char *ptr;
+
+        if (zeroed) {
+            ptr = cast(unsigned char *)mem_alloc(size, allocator);
+        } else {
+            ptr = cast(unsigned char *)mem_alloc_non_zeroed(size, allocator);
+        }
+        memset(ptr, i & 0xff, size);
+        bench_sink = ptr[size - 1];
+        mem_free_all(allocator);
+    }
+    stop = bench_now_ns();
+    return cast(f64)(stop - start) / BENCH_ITERATIONS;
+}
+
+static void
+bench_zeroing(const char *name, Allocator allocator)
+{
+    static const size_t sizes[] = {64, 4096, 64 * 1024, 1024 * 1024};
+
+    for (size_t i = 0; i < count_of(sizes); i += 1) {
+        size_t size = sizes[i];
+        f64 zeroed, non_zeroed;
+
+        zeroed     = bench_alloc_fill(allocator, size, /*zeroed=*/true);
+        non_zeroed = bench_alloc_fill(allocator, size, /*zeroed=*/false);
+
+        printfln("%-14s %8zu bytes: zeroed %10.1f ns, non-zeroed %10.1f ns",
+            name, size, zeroed, non_zeroed);
+    }
+}
+
+static size_t
+bench_churn_size(void)
+{
+    u64 r = bench_rng_next();
+    // Mostly small nodes, with the occasional big buffer mixed in.
+    if (r % 16 == 0) {
+        return cast(size_t)(1024 + (r >> 8) % (16 * 1024));
+    }
+    return cast(size_t)(16 + (r >> 8) % 512);
+}
+
+typedef struct {
+    f64    ns_per_op;
+    size_t failed;
+} Bench_Churn_Result;
+
+
+static unsigned char *
+bench_churn_ptrs[BENCH_CHURN_SLOTS];
+
+static size_t
+bench_churn_sizes[BENCH_CHURN_SLOTS];
+
+
+/** @brief Keep `BENCH_CHURN_SLOTS` blocks alive and replace or resize a
+ *  random one each round, freeing them out of order like a long-running
+ *  REPL session would. The live set is kept until `bench_churn_release`. */
+static Bench_Churn_Result
+bench_churn(Allocator allocator)
+{
+    unsigned char **ptrs = bench_churn_ptrs;
+    size_t *sizes = bench_churn_sizes;
+    Bench_Churn_Result result = {0, 0};
+    u64 start, stop;
+
+    bench_rng_state = BENCH_RNG_SEED;
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_CHURN_ROUNDS; i += 1) {
+        size_t slot, size;
+        unsigned char *ptr;
+
+        slot = cast(size_t)(bench_rng_next() % BENCH_CHURN_SLOTS);
+        size = bench_churn_size();
+        if (ptrs[slot] != NULL && i % 4 == 0) {
+            ptr = cast(unsigned char *)mem_resize_non_zeroed(ptrs[slot],
+                sizes[slot], size, allocator);
+        } else {
+            mem_free(ptrs[slot], sizes[slot], allocator);
+            ptr = cast(unsigned char *)mem_alloc_non_zeroed(size, allocator);
+        }
+
+        // Failed resizes leave the old block intact; free it to stay simple.
+        if (ptr == NULL) {
+            mem_free(ptrs[slot], sizes[slot], allocator);
+            result.failed += 1;
+            size = 0;
+        } else {
+            ptr[0] = ptr[size - 1] = cast(unsigned char)i;
+            bench_sink = ptr[0];
+        }
+        ptrs[slot]  = ptr;
+        sizes[slot] = size;
+    }
+    stop = bench_now_ns();
+
+    result.ns_per_op = cast(f64)(stop - start) / BENCH_CHURN_ROUNDS;
+    return result;
+}
+
+static void
+bench_churn_release(Allocator allocator)
+{
+    for (size_t slot = 0; slot < BENCH_CHURN_SLOTS; slot += 1) {
+        mem_free(bench_churn_ptrs[slot], bench_churn_sizes[slot], allocator);
+        bench_churn_ptrs[slot]  = NULL;
+        bench_churn_sizes[slot] = 0;
+    }
+}
+
+static void
+bench_free_list(const char *name, Free_List *fl)
+{
+    Bench_Churn_Result result;
+    size_t free_bytes = 0, largest = 0, nodes = 0;
+
+    result = bench_churn(free_list_allocator(fl));
+
+    // Measure fragmentation while the live set from the last round is still
+    // allocated.
+    for (Free_List_Node *node = fl->head; node != NULL; node = node->next) {
+        free_bytes += node->block_size;
+        largest     = (node->block_size > largest) ? node->block_size : largest;
+        nodes      += 1;
+    }
+    printfln("%-14s churn: %8.1f ns/op, %6zu failed, %5zu free blocks, "
+        "largest free %8zu / %8zu B (%5.1f%% fragmented)",
+        name, result.ns_per_op, result.failed, nodes, largest, free_bytes,
+        (free_bytes == 0) ? 0.0 : 100.0 * (1.0 - cast(f64)largest / cast(f64)free_bytes));
+
+    // Every neighbor should have coalesced back into a single block.
+    bench_churn_release(free_list_allocator(fl));
+    assert(fl->used == 0 && fl->head != NULL && fl->head->next == NULL);
+}
+
+typedef struct {
+    unsigned char *ptr;
+    size_t size;
+} Bench_Range;
+
+typedef struct {
+    // If set, each worker allocates from its own thread cache instead.
+    Thread_Cache_Global *cache;
+
+    Allocator    allocator;
+    unsigned char id;
+    Bench_Range  ranges[BENCH_THREAD_ALLOCS];
+    size_t       count;
+} Bench_Worker;
+
+static void *
+bench_worker_run(void *arg)
+{
+    Bench_Worker *w = cast(Bench_Worker *)arg;
+    u64 state = 0x9E3779B97F4A7C15u * (w->id + 1u);
+
+    if (w->cache != NULL) {
+        w->allocator = thread_cache_allocator(w->cache);
+    }
+    w->count = 0;
+    for (int i = 0; i < BENCH_THREAD_ALLOCS; i += 1) {
+        unsigned char *ptr;
+        size_t size, align;
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size  = cast(size_t)(1 + state % 256);
+        align = cast(size_t)1 << ((state >> 16) % 5);
+
+        ptr = cast(unsigned char *)mem_alloc_align_non_zeroed(size, align, w->allocator);
+        if (ptr == NULL) {
+            break;
+        }
+        assert((cast(uintptr_t)ptr & (align - 1)) == 0);
+        memset(ptr, w->id, size);
+        w->ranges[w->count].ptr  = ptr;
+        w->ranges[w->count].size = size;
+        w->count += 1;
+    }
+    return NULL;
+}
+
+static int
+bench_range_compare(const void *a, const void *b)
+{
+    uintptr_t x = cast(uintptr_t)(cast(const Bench_Range *)a)->ptr;
+    uintptr_t y = cast(uintptr_t)(cast(const Bench_Range *)b)->ptr;
+    return (x > y) - (x < y);
+}
+
+
+/** @brief Have `BENCH_THREAD_COUNT` threads allocate from `shared`, or from
+ *  their own caches in `cache`, at once. Then verify that no two allocations
+ *  overlap and that no thread scribbled over another's memory. */
+static void
+bench_threads(const char *name, Allocator shared, Thread_Cache_Global *cache)
+{
+    static Bench_Worker workers[BENCH_THREAD_COUNT];
+    static Bench_Range  ranges[BENCH_THREAD_COUNT * BENCH_THREAD_ALLOCS];
+    pthread_t threads[BENCH_THREAD_COUNT];
+    size_t count = 0, bytes = 0;
+    u64 start, stop;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_THREAD_COUNT; i += 1) {
+        workers[i].cache     = cache;
+        workers[i].allocator = shared;
+        workers[i].id        = cast(unsigned char)(i + 1);
+        pthread_create(&threads[i], NULL, bench_worker_run, &workers[i]);
+    }
+    for (int i = 0; i < BENCH_THREAD_COUNT; i += 1) {
+        pthread_join(threads[i], NULL);
+    }
+    stop = bench_now_ns();
+
+    for (int i = 0; i < BENCH_THREAD_COUNT; i += 1) {
+        Bench_Worker *w = &workers[i];
+        for (size_t j = 0; j < w->count; j += 1) {
+            Bench_Range r = w->ranges[j];
+            for (size_t k = 0; k < r.size; k += 1) {
+                assert(r.ptr[k] == w->id);
+            }
+            ranges[count++] = r;
+            bytes += r.size;
+        }
+    }
+
+    qsort(ranges, count, sizeof(ranges[0]), bench_range_compare);
+    for (size_t i = 1; i < count; i += 1) {
+        assert(ranges[i - 1].ptr + ranges[i - 1].size <= ranges[i].ptr);
+    }
+
+    printfln("%-14s %d threads: %zu allocations, %zu bytes, no overlaps, "
+        "%.1f ns/alloc (wall)", name, BENCH_THREAD_COUNT, count,
+        bytes, cast(f64)(stop - start) / cast(f64)count);
+
+    for (int i = 0; i < BENCH_THREAD_COUNT; i += 1) {
+        Bench_Worker *w = &workers[i];
+        for (size_t j = 0; j < w->count; j += 1) {
+            mem_free(w->ranges[j].ptr, w->ranges[j].size, w->allocator);
+        }
+    }
+}
+
+/** @brief Alternate between more globals than there are per-thread slots on
+ *  one thread, then destroy one and initialize another in its place. Every
+ *  global must end up with a single cache, and the new one must not inherit
+ *  the destroyed one's. */
+static void
+bench_thread_cache_switch(void)
+{
+    enum { GLOBAL_COUNT = MEM_THREAD_CACHE_SLOTS + 1, ROUNDS = 1000 };
+    Thread_Cache_Global globals[GLOBAL_COUNT];
+
+    for (size_t i = 0; i < GLOBAL_COUNT; i += 1) {
+        thread_cache_global_init(&globals[i], heap_allocator(), 0, 0);
+    }
+    for (int round = 0; round < ROUNDS; round += 1) {
+        for (size_t i = 0; i < GLOBAL_COUNT; i += 1) {
+            Allocator a = thread_cache_allocator(&globals[i]);
+            unsigned char *ptr = cast(unsigned char *)mem_alloc_non_zeroed(16, a);
+            assert(ptr != NULL);
+            ptr[15] = cast(unsigned char)round;
+            mem_free_all(a);
+        }
+    }
+    for (size_t i = 0; i < GLOBAL_COUNT; i += 1) {
+        Thread_Cache *cache = globals[i].caches;
+        assert(cache != NULL && cache->next == NULL && cache->global == &globals[i]);
+    }
+
+    thread_cache_global_destroy(&globals[0]);
+    thread_cache_global_init(&globals[0], heap_allocator(), 0, 0);
+    assert(thread_cache_allocator(&globals[0]).context == globals[0].caches);
+    assert(globals[0].caches != NULL && globals[0].caches->next == NULL);
+
+    for (size_t i = 0; i < GLOBAL_COUNT; i += 1) {
+        thread_cache_global_destroy(&globals[i]);
+    }
+    printfln("%-14s switch: %d globals on one thread, one cache each", "thread_cache",
+        GLOBAL_COUNT);
+}
+
+/** @brief Allocate, resize and free small blocks at random alignments up to
+ *  `MEM_SLAB_MAX_SIZE`, so that some are served by the backing allocator
+ *  but freed and resized by size alone. Then verify that every block kept
+ *  its contents and alignment, and that no two blocks overlap. */
+static void
+bench_slab_aligned(Slab *slab)
+{
+    static Bench_Range   ranges[BENCH_CHURN_SLOTS];
+    static size_t        aligns[BENCH_CHURN_SLOTS];
+    static unsigned char fills[BENCH_CHURN_SLOTS];
+    Allocator allocator = slab_allocator(slab);
+    size_t count = 0, foreign_peak = 0, in_place = 0;
+
+    bench_rng_state = BENCH_RNG_SEED;
+    for (int i = 0; i < BENCH_CHURN_ROUNDS; i += 1) {
+        size_t slot, size;
+        Bench_Range *r;
+        u64 rng;
+
+        rng  = bench_rng_next();
+        slot = cast(size_t)(rng % BENCH_CHURN_SLOTS);
+        size = cast(size_t)(1 + (rng >> 16) % MEM_SLAB_MAX_SIZE);
+        r    = &ranges[slot];
+        if (r->ptr == NULL) {
+            aligns[slot] = cast(size_t)1 << ((rng >> 32) % 9);
+            r->ptr  = cast(unsigned char *)mem_alloc_align_non_zeroed(size,
+                aligns[slot], allocator);
+            r->size = size;
+        } else {
+            for (size_t k = 0; k < r->size; k += 1) {
+                assert(r->ptr[k] == fills[slot]);
+            }
+            switch ((rng >> 48) % 3) {
+            case 0:
+                mem_free(r->ptr, r->size, allocator);
+                r->ptr = NULL;
+                continue;
+            case 1:
+                // Whatever succeeds has to really have room for `size` bytes.
+                if (!mem_try_resize_in_place(r->ptr, r->size, size, allocator)) {
+                    continue;
+                }
+                in_place += 1;
+                break;
+            case 2:
+                r->ptr = cast(unsigned char *)mem_resize_align_non_zeroed(r->ptr,
+                    r->size, size, aligns[slot], allocator);
+                break;
+            }
+            r->size = size;
+        }
+        assert(r->ptr != NULL);
+        assert((cast(uintptr_t)r->ptr & (aligns[slot] - 1)) == 0);
+        fills[slot] = cast(unsigned char)i;
+        memset(r->ptr, fills[slot], r->size);
+        if (slab->foreign_count > foreign_peak) {
+            foreign_peak = slab->foreign_count;
+        }
+    }
+
+    {
+        static Bench_Range sorted[BENCH_CHURN_SLOTS];
+        for (size_t slot = 0; slot < BENCH_CHURN_SLOTS; slot += 1) {
+            if (ranges[slot].ptr != NULL) {
+                sorted[count++] = ranges[slot];
+            }
+        }
+        qsort(sorted, count, sizeof(sorted[0]), bench_range_compare);
+        for (size_t i = 1; i < count; i += 1) {
+            assert(sorted[i - 1].ptr + sorted[i - 1].size <= sorted[i].ptr);
+        }
+    }
+
+    for (size_t slot = 0; slot < BENCH_CHURN_SLOTS; slot += 1) {
+        mem_free(ranges[slot].ptr, ranges[slot].size, allocator);
+        ranges[slot].ptr = NULL;
+    }
+    assert(slab->foreign_count == 0);
+    printfln("%-14s aligned: %d rounds, %zu live at the end, %zu resized in "
+        "place, up to %zu served by backing, no overlaps", "slab",
+        BENCH_CHURN_ROUNDS, count, in_place, foreign_peak);
+}
+
+#define BENCH_POOL_NODE_SIZE    48
+
+/** @brief Count the chunks that `p` can hand out before running dry, then
+ *  give them all back. Only meant for fixed-buffer pools. */
+static size_t
+bench_pool_capacity(Pool *p)
+{
+    size_t capacity = 0;
+
+    while (pool_alloc_non_zeroed(p) != NULL) {
+        capacity += 1;
+    }
+    pool_free_all(p);
+    return capacity;
+}
+
+/** @brief Allocate and free fixed-size nodes at random, filling each with its
+ *  own byte. Then verify that every node kept its contents and alignment, and
+ *  that no two nodes overlap. A fixed-buffer pool must get all of its chunks
+ *  back once every node is freed. */
+static void
+bench_pool(const char *name, Pool *p)
+{
+    static Bench_Range   ranges[BENCH_CHURN_SLOTS];
+    static unsigned char fills[BENCH_CHURN_SLOTS];
+    bool fixed = (p->buf != NULL);
+    size_t capacity = 0, count = 0, failed = 0;
+    u64 start, stop;
+
+    if (fixed) {
+        capacity = bench_pool_capacity(p);
+    }
+
+    bench_rng_state = BENCH_RNG_SEED;
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_CHURN_ROUNDS; i += 1) {
+        size_t slot;
+        Bench_Range *r;
+        u64 rng;
+
+        rng  = bench_rng_next();
+        slot = cast(size_t)(rng % BENCH_CHURN_SLOTS);
+        r    = &ranges[slot];
+        if (r->ptr != NULL) {
+            for (size_t k = 0; k < r->size; k += 1) {
+                assert(r->ptr[k] == fills[slot]);
+            }
+            pool_free(p, r->ptr);
+            r->ptr = NULL;
+            continue;
+        }
+
+        if ((rng >> 32) & 1) {
+            r->ptr = cast(unsigned char *)pool_alloc(p);
+            for (size_t k = 0; r->ptr != NULL && k < BENCH_POOL_NODE_SIZE; k += 1) {
+                assert(r->ptr[k] == 0);
+            }
+        } else {
+            r->ptr = cast(unsigned char *)pool_alloc_non_zeroed(p);
+        }
+        if (r->ptr == NULL) {
+            failed += 1;
+            continue;
+        }
+        assert((cast(uintptr_t)r->ptr & (p->chunk_align - 1)) == 0);
+        assert(pool_owns(p, r->ptr));
+        r->size     = BENCH_POOL_NODE_SIZE;
+        fills[slot] = cast(unsigned char)i;
+        memset(r->ptr, fills[slot], r->size);
+    }
+    stop = bench_now_ns();
+
+    {
+        static Bench_Range sorted[BENCH_CHURN_SLOTS];
+        for (size_t slot = 0; slot < BENCH_CHURN_SLOTS; slot += 1) {
+            if (ranges[slot].ptr != NULL) {
+                sorted[count++] = ranges[slot];
+            }
+        }
+        qsort(sorted, count, sizeof(sorted[0]), bench_range_compare);
+        for (size_t i = 1; i < count; i += 1) {
+            assert(sorted[i - 1].ptr + sorted[i - 1].size <= sorted[i].ptr);
+        }
+    }
+
+    for (size_t slot = 0; slot < BENCH_CHURN_SLOTS; slot += 1) {
+        if (ranges[slot].ptr != NULL) {
+            pool_free(p, ranges[slot].ptr);
+            ranges[slot].ptr = NULL;
+        }
+    }
+    if (fixed) {
+        // Every chunk is back on the free list, not just those carved so far.
+        size_t reused = 0;
+        while (pool_alloc_non_zeroed(p) != NULL) {
+            reused += 1;
+        }
+        assert(reused == capacity);
+        pool_free_all(p);
+    }
+    printfln("%-14s churn: %8.1f ns/op, %6zu failed, %zu live at the end, "
+        "no overlaps", name, cast(f64)(stop - start) / BENCH_CHURN_ROUNDS,
+        failed, count);
+}
+
+/** @brief Append a request for the block `id` with the default alignment. */
+static void
+bench_trace_push(Trace *t, Allocator_Mode mode, size_t id, size_t size)
+{
+    Trace_Op op = {mode, id, size, MEM_DEFAULT_ALIGNMENT};
+    if (!trace_push(t, op)) {
+        fputs("bench: out of memory\n", stderr);
+        exit(1);
+    }
+}
+
+
+/** @brief Push a random number of blocks, then pop them all. */
+static void
+bench_trace_lifo(Trace *t)
+{
+    while (t->count < BENCH_TRACE_OPS) {
+        u32 depth = cast(u32)(1 + bench_rng_next() % 64);
+        for (u32 id = 0; id < depth; id += 1) {
+            bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, 16 + bench_rng_next() % 1024);
+        }
+        for (u32 id = depth; id > 0; id -= 1) {
+            bench_trace_push(t, ALLOCATOR_FREE, id - 1, 0);
+        }
+    }
+}
+
+
+/** @brief Keep a queue of blocks alive, always freeing the oldest. */
+static void
+bench_trace_fifo(Trace *t)
+{
+    enum { QUEUE_LEN = 256 };
+
+    for (u32 id = 0; id < QUEUE_LEN; id += 1) {
+        bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, 16 + bench_rng_next() % 1024);
+    }
+    for (u32 i = 0; t->count < BENCH_TRACE_OPS; i += 1) {
+        u32 id = i % QUEUE_LEN;
+        bench_trace_push(t, ALLOCATOR_FREE, id, 0);
+        bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, 16 + bench_rng_next() % 1024);
+    }
+}
+
+
+/** @brief Replace random blocks with ones of random size, like
+ *  `bench_churn` minus the resizes. */
+static void
+bench_trace_random(Trace *t)
+{
+    static bool live[BENCH_CHURN_SLOTS];
+
+    memset(live, 0, sizeof(live));
+    while (t->count < BENCH_TRACE_OPS) {
+        u32 id = cast(u32)(bench_rng_next() % BENCH_CHURN_SLOTS);
+        if (live[id]) {
+            bench_trace_push(t, ALLOCATOR_FREE, id, 0);
+        }
+        bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, bench_churn_size());
+        live[id] = true;
+    }
+}
+
+
+/** @brief Grow a few interleaved buffers by 1.5x until they reach 64 KiB,
+ *  then start over. Mimics string builders and digit arrays that outgrow
+ *  themselves. */
+static void
+bench_trace_grow(Trace *t)
+{
+    enum { CHAIN_COUNT = 4, CHAIN_MAX = 64 * 1024 };
+    size_t sizes[CHAIN_COUNT] = {0};
+
+    for (u32 i = 0; t->count < BENCH_TRACE_OPS; i += 1) {
+        u32 id = i % CHAIN_COUNT;
+        if (sizes[id] == 0) {
+            sizes[id] = 16;
+            bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, sizes[id]);
+        } else if (sizes[id] >= CHAIN_MAX) {
+            sizes[id] = 0;
+            bench_trace_push(t, ALLOCATOR_FREE, id, 0);
+        } else {
+            sizes[id] += sizes[id] / 2;
+            bench_trace_push(t, ALLOCATOR_RESIZE_NON_ZEROED, id, sizes[id]);
+        }
+    }
+}
+
+
+/** @brief Mimic one line of the bigint REPL at a time: a few token strings,
+ *  small digit arrays that grow as carries propagate, and the output string
+ *  doubling as it is built. Everything is dropped at the end of the line.
+ *  Like `Trace_Recorder`, ids are never reused. */
+static void
+bench_trace_bigint(Trace *t)
+{
+    size_t id = 0;
+
+    while (t->count < BENCH_TRACE_OPS) {
+        u32 token_count = cast(u32)(3 + bench_rng_next() % 6);
+        size_t size;
+
+        for (u32 i = 0; i < token_count; i += 1) {
+            bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id++, 8 + bench_rng_next() % 32);
+        }
+        for (u32 i = 0; i < token_count / 2; i += 1) {
+            u64 carries = bench_rng_next() % 4;
+
+            size = 8 * (1 + bench_rng_next() % 4);
+            bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, size);
+            for (u64 j = 0; j < carries; j += 1) {
+                size += 8;
+                bench_trace_push(t, ALLOCATOR_RESIZE_NON_ZEROED, id, size);
+            }
+            id += 1;
+        }
+
+        size = 16;
+        bench_trace_push(t, ALLOCATOR_ALLOC_NON_ZEROED, id, size);
+        for (u64 j = bench_rng_next() % 6; j > 0; j -= 1) {
+            size *= 2;
+            bench_trace_push(t, ALLOCATOR_RESIZE_NON_ZEROED, id, size);
+        }
+        bench_trace_push(t, ALLOCATOR_FREE_ALL, 0, 0);
+    }
+}
+
+typedef struct Bench_Node Bench_Node;
+struct Bench_Node {
+    Bench_Node *next;
+    u64 value;
+};
+
+
+/** @brief Build a linked list, allocating and freeing a temporary buffer
+ *  between every two nodes, then time walking it. Allocators that reuse the
+ *  temporaries' memory keep the nodes dense; the others scatter them and
+ *  walking the list misses the cache far more often.
+ *
+ * @return Average nanoseconds per node visited, or a negative number if the
+ *  allocator ran out of memory.
+ */
+static f64
+bench_layout(Allocator allocator)
+{
+    Bench_Node *head = NULL, *prev = NULL, **tail = &head;
+    u64 start, stop, sum = 0;
+
+    bench_rng_state = BENCH_RNG_SEED;
+    mem_free_all(allocator);
+    for (u64 i = 0; i < BENCH_LAYOUT_NODES; i += 1) {
+        unsigned char *temp;
+        Bench_Node *node;
+        size_t size;
+
+        node = cast(Bench_Node *)mem_alloc_non_zeroed(sizeof(*node), allocator);
+        if (node == NULL) {
+            mem_free_all(allocator);
+            return -1;
+        }
+        node->next  = NULL;
+        node->value = i;
+        *tail       = node;
+        tail        = &node->next;
+
+        size = cast(size_t)(64 + bench_rng_next() % 2048);
+        temp = cast(unsigned char *)mem_alloc_non_zeroed(size, allocator);
+        if (temp != NULL) {
+            temp[0] = temp[size - 1] = cast(unsigned char)i;
+            mem_free(temp, size, allocator);
+        }
+    }
+
+    start = bench_now_ns();
+    for (int pass = 0; pass < BENCH_LAYOUT_PASSES; pass += 1) {
+        for (Bench_Node *node = head; node != NULL; node = node->next) {
+            sum += node->value;
+        }
+    }
+    stop = bench_now_ns();
+    bench_sink = cast(unsigned char)sum;
+
+    // Reverse the list to free the most recent node first, for `Stack`.
+    for (Bench_Node *node = head, *next; node != NULL; node = next) {
+        next       = node->next;
+        node->next = prev;
+        prev       = node;
+    }
+    for (Bench_Node *node = prev, *next; node != NULL; node = next) {
+        next = node->next;
+        mem_free(node, sizeof(*node), allocator);
+    }
+    mem_free_all(allocator);
+    return cast(f64)(stop - start) / (BENCH_LAYOUT_PASSES * BENCH_LAYOUT_NODES);
+}
+
+typedef struct {
+    const char *name;
+    Allocator   allocator;
+
+    // Can only run traces that free in LIFO order.
+    bool lifo_only;
+
+    // Carves up a single buffer, so `Trace_Replay.peak_span` is its footprint.
+    bool single_buffer;
+} Bench_Allocator;
+
+static void
+bench_trace_run(const char *name,
+    const Trace           *t,
+    const Bench_Allocator *allocators,
+    size_t                 allocator_count)
+{
+    Trace_Replay r;
+    bool lifo = trace_is_lifo(t);
+
+    if (!trace_replay_init(&r, t, heap_allocator())) {
+        printfln("trace %s: out of memory", name);
+        return;
+    }
+
+    printfln("trace %s: %zu ops, %zu ids%s", name, t->count, t->id_count,
+        lifo ? ", lifo" : "");
+    for (size_t i = 0; i < allocator_count; i += 1) {
+        const Bench_Allocator *a = &allocators[i];
+        u64 start, stop;
+        f64 ns_per_op;
+
+        if (a->lifo_only && !lifo) {
+            printfln("    %-14s skipped; frees out of order", a->name);
+            continue;
+        }
+
+        // Whatever is left live at the end is not part of the trace.
+        start = bench_now_ns();
+        trace_replay_run(&r, t, a->allocator);
+        stop  = bench_now_ns();
+        trace_replay_release(&r, a->allocator);
+
+        ns_per_op = cast(f64)(stop - start) / cast(f64)t->count;
+        if (a->single_buffer) {
+            printfln("    %-14s %8.1f ns/op, %6zu failed, peak %9zu B requested, "
+                "%9zu B used", a->name, ns_per_op, r.failed, r.peak_requested,
+                r.peak_span);
+        } else {
+            printfln("    %-14s %8.1f ns/op, %6zu failed, peak %9zu B requested",
+                a->name, ns_per_op, r.failed, r.peak_requested);
+        }
+    }
+    trace_replay_destroy(&r);
+}
+
+
+/** @brief Replay each trace file in `paths`, or if there are none, run every
+ *  synthetic trace and then `bench_layout`, against every allocator. All of
+ *  them share the same static buffer, one after another. */
+static void
+bench_traces(char **paths, int path_count)
+{
+    static unsigned char buf[BENCH_TRACE_BUFFER_SIZE];
+    static const struct {
+        const char *name;
+        void (*generate)(Trace *t);
+    } generators[] = {
+        {"lifo",   bench_trace_lifo},
+        {"fifo",   bench_trace_fifo},
+        {"random", bench_trace_random},
+        {"grow",   bench_trace_grow},
+        {"bigint", bench_trace_bigint},
+    };
+    Arena arena;
+    Stack stack;
+    Free_List fl;
+    Growing_Arena growing;
+    Slab slab;
+
+    arena_init(&arena, buf, sizeof(buf));
+    stack_init(&stack, buf, sizeof(buf));
+    free_list_init(&fl, buf, sizeof(buf), FREE_LIST_POLICY_FIRST_FIT);
+    growing_arena_init(&growing, /*block_size=*/0, heap_allocator());
+    slab_init(&slab, heap_allocator());
+
+    const Bench_Allocator allocators[] = {
+        {"arena",         arena_allocator(&arena),           false, true},
+        {"stack",         stack_allocator(&stack),           true,  true},
+        {"free_list",     free_list_allocator(&fl),          false, true},
+        {"growing_arena", growing_arena_allocator(&growing), false, false},
+        {"slab",          slab_allocator(&slab),             false, false},
+        {"heap",          heap_allocator(),                  false, false},
+    };
+
+    for (int i = 0; i < path_count; i += 1) {
+        FILE *stream;
+        Trace t;
+        Trace_Error err;
+
+        stream = fopen(paths[i], "rb");
+        if (stream == NULL) {
+            fprintf(stderr, "bench: failed to open '%s'\n", paths[i]);
+            continue;
+        }
+        trace_init(&t, heap_allocator());
+        err = trace_read(&t, stream);
+        fclose(stream);
+        if (err == TRACE_OK) {
+            bench_trace_run(paths[i], &t, allocators, count_of(allocators));
+        } else {
+            fprintf(stderr, "bench: '%s' is not a valid trace\n", paths[i]);
+        }
+        trace_destroy(&t);
+    }
+
+    if (path_count > 0) {
+        growing_arena_destroy(&growing);
+        slab_destroy(&slab);
+        return;
+    }
+
+    for (size_t i = 0; i < count_of(generators); i += 1) {
+        Trace t;
+
+        trace_init(&t, heap_allocator());
+        bench_rng_state = BENCH_RNG_SEED;
+        generators[i].generate(&t);
+        bench_trace_run(generators[i].name, &t, allocators, count_of(allocators));
+        trace_destroy(&t);
+    }
+
+    printfln("layout: walk %d nodes allocated between temporaries", BENCH_LAYOUT_NODES);
+    for (size_t i = 0; i < count_of(allocators); i += 1) {
+        f64 ns = bench_layout(allocators[i].allocator);
+        if (ns < 0) {
+            printfln("    %-14s out of memory", allocators[i].name);
+        } else {
+            printfln("    %-14s %8.2f ns/node", allocators[i].name, ns);
+        }
+    }
+    growing_arena_destroy(&growing);
+    slab_destroy(&slab);
+}
+
+
+/** @brief Grow one buffer by doubling from `BENCH_HUGE_MIN` to
+ *  `BENCH_HUGE_MAX` bytes, touching every new byte. Mimics a dynamic string
+ *  or grid that keeps outgrowing itself. */
+static void
+bench_huge(const char *name, Allocator allocator)
+{
+    unsigned char *buf;
+    size_t size = BENCH_HUGE_MIN;
+    u64 start, stop;
+
+    start = bench_now_ns();
+    buf   = cast(unsigned char *)mem_alloc_non_zeroed(size, allocator);
+    memset(buf, 1, size);
+    while (size < BENCH_HUGE_MAX) {
+        buf = cast(unsigned char *)mem_resize_non_zeroed(buf, size, size * 2, allocator);
+        assert(buf != NULL && buf[size - 1] == 1);
+        memset(buf + size, 1, size);
+        size *= 2;
+    }
+    bench_sink = buf[size - 1];
+    mem_free(buf, size, allocator);
+    stop = bench_now_ns();
+
+    printfln("%-14s huge: %zu MiB by doubling in %.2f ms", name,
+        size / (1024 * 1024), cast(f64)(stop - start) / 1e6);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static unsigned char buf[2 * 1024 * 1024];
+    Arena arena;
+    Stack stack;
+    Growing_Arena growing;
+
+    // Only replay the given traces, e.g. those recorded by bigint.
+    if (argc > 1) {
+        bench_traces(argv + 1, argc - 1);
+        return 0;
+    }
+
+    arena_init(&arena, buf, sizeof(buf));
+    bench_zeroing("arena", arena_allocator(&arena));
+
+    stack_init(&stack, buf, sizeof(buf));
+    bench_zeroing("stack", stack_allocator(&stack));
+
+    growing_arena_init(&growing, /*block_size=*/0, heap_allocator());
+    bench_zeroing("growing_arena", growing_arena_allocator(&growing));
+    growing_arena_destroy(&growing);
+
+    {
+        static unsigned char churn_buf[16 * 1024 * 1024];
+        Free_List fl;
+        Bench_Churn_Result result;
+
+        free_list_init(&fl, churn_buf, sizeof(churn_buf), FREE_LIST_POLICY_FIRST_FIT);
+        bench_free_list("first_fit", &fl);
+
+        free_list_init(&fl, churn_buf, sizeof(churn_buf), FREE_LIST_POLICY_BEST_FIT);
+        bench_free_list("best_fit", &fl);
+
+        // Same realloc/free pair as `default_allocator_fn` in bigint/main.c.
+        result = bench_churn(heap_allocator());
+        bench_churn_release(heap_allocator());
+        printfln("%-14s churn: %8.1f ns/op, %6zu failed",
+            "heap", result.ns_per_op, result.failed);
+    }
+
+    {
+        // `heap_allocator` only supports the default alignment.
+        static unsigned char slab_buf[16 * 1024 * 1024];
+        Free_List fl;
+        Slab slab;
+
+        free_list_init(&fl, slab_buf, sizeof(slab_buf), FREE_LIST_POLICY_FIRST_FIT);
+        slab_init(&slab, free_list_allocator(&fl));
+        bench_slab_aligned(&slab);
+        slab_destroy(&slab);
+        assert(fl.used == 0);
+    }
+
+    {
+        // Room for fewer nodes than there are slots, so the fixed pool runs dry.
+        static unsigned char pool_buf[512 * BENCH_POOL_NODE_SIZE];
+        Pool pool;
+
+        pool_init(&pool, pool_buf, sizeof(pool_buf), BENCH_POOL_NODE_SIZE, 16);
+        bench_pool("pool fixed", &pool);
+
+        pool_init_growing(&pool, BENCH_POOL_NODE_SIZE, 16, /*chunk_count=*/64,
+            heap_allocator());
+        bench_pool("pool growing", &pool);
+        pool_destroy(&pool);
+    }
+
+    {
+        static unsigned char shared_buf[16 * 1024 * 1024];
+        Atomic_Arena a;
+
+        atomic_arena_init(&a, shared_buf, sizeof(shared_buf));
+        bench_zeroing("atomic_arena", atomic_arena_allocator(&a));
+        bench_threads("atomic_arena", atomic_arena_allocator(&a), NULL);
+    }
+
+    {
+        Thread_Cache_Global g;
+
+        thread_cache_global_init(&g, heap_allocator(), 0, 0);
+        // Every request contends for the same spinlock.
+        bench_threads("locked_heap", thread_cache_global_allocator(&g), NULL);
+        bench_threads("thread_cache", thread_cache_global_allocator(&g), &g);
+
+        // Phase boundary: the workers have joined, so every arena may be
+        // reset at once.
+        thread_cache_global_reset(&g);
+        bench_threads("thread_cache", thread_cache_global_allocator(&g), &g);
+        thread_cache_global_destroy(&g);
+        bench_thread_cache_switch();
+    }
+
+    {
+        Page_Allocator p;
+
+        page_allocator_init(&p, /*threshold=*/0, heap_allocator());
+        bench_huge("heap", heap_allocator());
+        bench_huge("page", page_allocator(&p));
+    }
+
+    bench_traces(NULL, 0);
+    return 0;
+}
@@ -0,0 +1,306 @@
+#include <string.h> // memset, memcpy, memmove
+
+#include "double_stack.h"
+
+void
+double_stack_init(Double_Stack *ds, void *backing_buffer, size_t backing_buffer_length)
+{
+    ds->buf     = cast(unsigned char *)backing_buffer;
+    ds->buf_len = backing_buffer_length;
+    for (int i = DOUBLE_STACK_FRONT; i <= DOUBLE_STACK_BACK; i += 1) {
+        ds->sides[i].owner = ds;
+        ds->sides[i].end   = cast(Double_Stack_End)i;
+        double_stack_free_all(ds, cast(Double_Stack_End)i);
+    }
+}
+
+size_t
+double_stack_remaining(const Double_Stack *ds)
+{
+    return ds->sides[DOUBLE_STACK_BACK].offset - ds->sides[DOUBLE_STACK_FRONT].offset;
+}
+
+void *
+double_stack_alloc(Double_Stack *ds, Double_Stack_End end, size_t size)
+{
+    return double_stack_alloc_align(ds, end, size, MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+double_stack_alloc_align(Double_Stack *ds, Double_Stack_End end, size_t size, size_t align)
+{
+    void *ptr = double_stack_alloc_align_non_zeroed(ds, end, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+double_stack_alloc_align_non_zeroed(Double_Stack *ds,
+    Double_Stack_End end,
+    size_t           size,
+    size_t           align)
+{
+    Double_Stack_Side *side = &ds->sides[end];
+    Double_Stack_Header *header;
+    uintptr_t start, user, lo, hi;
+
+    assert(mem_is_power_of_two(align));
+    // The header must be properly aligned as well.
+    if (align < alignof(Double_Stack_Header)) {
+        align = alignof(Double_Stack_Header);
+    }
+
+    start = cast(uintptr_t)ds->buf;
+    lo    = start + ds->sides[DOUBLE_STACK_FRONT].offset;
+    hi    = start + ds->sides[DOUBLE_STACK_BACK].offset;
+    if (hi - lo < sizeof(*header) + size) {
+        return NULL;
+    }
+
+    if (end == DOUBLE_STACK_FRONT) {
+        user = mem_align_forward(lo + sizeof(*header), align);
+        if (user > hi || hi - user < size) {
+            return NULL;
+        }
+    } else {
+        // Round down to keep the block within the back.
+        user = (hi - size) & ~cast(uintptr_t)(align - 1);
+        if (user < lo + sizeof(*header)) {
+            return NULL;
+        }
+    }
+
+    header                 = cast(Double_Stack_Header *)user - 1;
+    header->prev_offset    = side->prev_offset;
+    header->restore_offset = side->offset;
+    side->prev_offset      = cast(size_t)(cast(uintptr_t)header - start);
+    if (end == DOUBLE_STACK_FRONT) {
+        side->offset = cast(size_t)(user + size - start);
+    } else {
+        side->offset = side->prev_offset;
+    }
+    return cast(void *)user;
+}
+
+void *
+double_stack_resize_align(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size,
+    size_t           align)
+{
+    unsigned char *new_ptr;
+
+    new_ptr = double_stack_resize_align_non_zeroed(ds, end, old_ptr, old_size,
+        new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_ptr != NULL && old_size < new_size) {
+        memset(new_ptr + old_size, 0, new_size - old_size);
+    }
+    return new_ptr;
+}
+
+
+/** @brief Whether `ptr` is a live block on `end`. */
+static bool
+internal_double_stack_owns(const Double_Stack *ds, Double_Stack_End end, const void *ptr)
+{
+    const unsigned char *addr = cast(const unsigned char *)ptr;
+    size_t offset = ds->sides[end].offset;
+
+    if (end == DOUBLE_STACK_FRONT) {
+        return ds->buf <= addr && addr < ds->buf + offset;
+    }
+    return ds->buf + offset <= addr && addr < ds->buf + ds->buf_len;
+}
+
+static bool
+internal_double_stack_is_top(const Double_Stack *ds, Double_Stack_End end, const void *ptr)
+{
+    const unsigned char *header;
+
+    header = cast(const unsigned char *)(cast(const Double_Stack_Header *)ptr - 1);
+    return cast(size_t)(header - ds->buf) == ds->sides[end].prev_offset;
+}
+
+void *
+double_stack_resize_align_non_zeroed(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size,
+    size_t           align)
+{
+    Double_Stack_Side *side = &ds->sides[end];
+    unsigned char *new_ptr;
+    size_t min_size = (old_size < new_size) ? old_size : new_size;
+
+    if (old_ptr == NULL) {
+        return double_stack_alloc_align_non_zeroed(ds, end, new_size, align);
+    } else if (new_size == 0) {
+        double_stack_free(ds, end, old_ptr);
+        return NULL;
+    } else if (!internal_double_stack_owns(ds, end, old_ptr)) {
+        assert(0 && "Out of bounds memory address passed to double stack allocator (resize)");
+        return NULL;
+    }
+
+    if ((cast(uintptr_t)old_ptr & (align - 1)) == 0
+        && double_stack_try_resize_in_place(ds, end, old_ptr, old_size, new_size))
+    {
+        return old_ptr;
+    }
+
+    // The top of the back can grow by sliding further down, as long as its
+    // new header lands below its old contents.
+    if (end == DOUBLE_STACK_BACK && internal_double_stack_is_top(ds, end, old_ptr)) {
+        Double_Stack_Header header = *(cast(Double_Stack_Header *)old_ptr - 1);
+        size_t old_offset = side->offset;
+        size_t old_prev   = side->prev_offset;
+        uintptr_t user;
+
+        if (align < alignof(Double_Stack_Header)) {
+            align = alignof(Double_Stack_Header);
+        }
+        user = (cast(uintptr_t)ds->buf + header.restore_offset - new_size)
+            & ~cast(uintptr_t)(align - 1);
+        if (header.restore_offset >= new_size && user < cast(uintptr_t)old_ptr) {
+            // Pretend it was freed, then allocate again from where it started.
+            side->offset      = header.restore_offset;
+            side->prev_offset = header.prev_offset;
+            new_ptr = cast(unsigned char *)double_stack_alloc_align_non_zeroed(ds, end,
+                new_size, align);
+            if (new_ptr == NULL) {
+                // Neither the old header nor its contents were touched.
+                side->offset      = old_offset;
+                side->prev_offset = old_prev;
+                return NULL;
+            }
+            assert(cast(uintptr_t)new_ptr == user);
+            return memmove(new_ptr, old_ptr, min_size);
+        }
+    }
+
+    // The old block stays put until everything above it is freed.
+    new_ptr = cast(unsigned char *)double_stack_alloc_align_non_zeroed(ds, end,
+        new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    return memcpy(new_ptr, old_ptr, min_size);
+}
+
+bool
+double_stack_try_resize_in_place(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size)
+{
+    size_t user_offset;
+
+    if (!internal_double_stack_owns(ds, end, old_ptr)) {
+        return false;
+    } else if (new_size <= old_size) {
+        // Leaves the rest unused until everything above it is freed.
+        if (end == DOUBLE_STACK_FRONT && internal_double_stack_is_top(ds, end, old_ptr)) {
+            ds->sides[end].offset -= old_size - new_size;
+        }
+        return true;
+    } else if (end == DOUBLE_STACK_BACK || !internal_double_stack_is_top(ds, end, old_ptr)) {
+        return false;
+    }
+
+    user_offset = cast(size_t)(cast(unsigned char *)old_ptr - ds->buf);
+    if (new_size > ds->sides[DOUBLE_STACK_BACK].offset - user_offset) {
+        return false;
+    }
+    ds->sides[end].offset = user_offset + new_size;
+    return true;
+}
+
+void
+double_stack_free(Double_Stack *ds, Double_Stack_End end, void *ptr)
+{
+    Double_Stack_Side *side = &ds->sides[end];
+    Double_Stack_Header *header;
+    unsigned char *addr;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    addr = cast(unsigned char *)ptr;
+    if (!(ds->buf <= addr && addr < ds->buf + ds->buf_len)) {
+        assert(0 && "Out of bounds memory address passed to double stack allocator (free)");
+        return;
+    }
+
+    if (!internal_double_stack_owns(ds, end, ptr)) {
+        // Allow double frees
+        return;
+    }
+
+    if (!internal_double_stack_is_top(ds, end, ptr)) {
+        assert(0 && "Out of order double stack allocator free");
+        return;
+    }
+
+    header            = cast(Double_Stack_Header *)ptr - 1;
+    side->offset      = header->restore_offset;
+    side->prev_offset = header->prev_offset;
+}
+
+void
+double_stack_free_all(Double_Stack *ds, Double_Stack_End end)
+{
+    ds->sides[end].offset      = (end == DOUBLE_STACK_FRONT) ? 0 : ds->buf_len;
+    ds->sides[end].prev_offset = SIZE_MAX;
+}
+
+static void *
+double_stack_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Double_Stack_Side *side = cast(Double_Stack_Side *)context;
+    Double_Stack *ds = side->owner;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return double_stack_alloc_align(ds, side->end, new_size, align);
+    case ALLOCATOR_RESIZE:
+        return double_stack_resize_align(ds, side->end, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_FREE:
+        double_stack_free(ds, side->end, old_ptr);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        double_stack_free_all(ds, side->end);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return double_stack_alloc_align_non_zeroed(ds, side->end, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return double_stack_resize_align_non_zeroed(ds, side->end, old_ptr, old_size,
+            new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (double_stack_try_resize_in_place(ds, side->end, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+double_stack_allocator(Double_Stack *ds, Double_Stack_End end)
+{
+    Allocator a = {double_stack_allocator_fn, &ds->sides[end]};
+    return a;
+}
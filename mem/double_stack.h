@@ -0,0 +1,126 @@
+#ifndef MEM_DOUBLE_STACK_H
+#define MEM_DOUBLE_STACK_H
+
+#include "allocator.h"
+
+typedef enum {
+    // Grows up from the start of the buffer.
+    DOUBLE_STACK_FRONT,
+
+    // Grows down from the end of the buffer.
+    DOUBLE_STACK_BACK,
+} Double_Stack_End;
+
+// Lives right before the user's pointer, on both ends.
+typedef struct Double_Stack_Header Double_Stack_Header;
+struct Double_Stack_Header {
+    // Index of the header of the previous block on the same end, if any.
+    size_t prev_offset;
+
+    // The end's `offset` before this block was allocated.
+    size_t restore_offset;
+};
+
+typedef struct Double_Stack Double_Stack;
+
+typedef struct Double_Stack_Side Double_Stack_Side;
+struct Double_Stack_Side {
+    Double_Stack    *owner;
+    Double_Stack_End end;
+
+    // For the front, the index of the first available byte. For the back, the
+    // index of the first byte in use.
+    size_t offset;
+
+    // Index of the header of the most recent block on this end, or
+    // `SIZE_MAX` if there is none.
+    size_t prev_offset;
+};
+
+/**
+ * @brief Two LIFO stacks sharing one buffer, growing towards each other.
+ *  Useful for keeping results on one end and temporaries on the other
+ *  without splitting the buffer up front.
+ */
+struct Double_Stack {
+    unsigned char *buf;
+    size_t buf_len;
+
+    // Indexed by `Double_Stack_End`.
+    Double_Stack_Side sides[2];
+};
+
+void
+double_stack_init(Double_Stack *ds, void *backing_buffer, size_t backing_buffer_length);
+
+
+/** @brief Bytes left between both ends, before headers and padding. */
+size_t
+double_stack_remaining(const Double_Stack *ds);
+
+void *
+double_stack_alloc(Double_Stack *ds, Double_Stack_End end, size_t size);
+
+void *
+double_stack_alloc_align(Double_Stack *ds, Double_Stack_End end, size_t size, size_t align);
+
+
+/** @brief Like `double_stack_alloc_align`, but the memory is not zeroed. */
+void *
+double_stack_alloc_align_non_zeroed(Double_Stack *ds,
+    Double_Stack_End end,
+    size_t           size,
+    size_t           align);
+
+
+/** @brief The most recent block on either end may be resized in-place, or
+ *  for the back, slid down to make room. Any other block only shrinks
+ *  in-place, else it is copied to the top of its end. */
+void *
+double_stack_resize_align(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size,
+    size_t           align);
+
+
+/** @brief Like `double_stack_resize_align`, but the growth region is not
+ *  zeroed. */
+void *
+double_stack_resize_align_non_zeroed(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size,
+    size_t           align);
+
+
+/** @brief Resize `old_ptr` without moving it. Every block can shrink, but
+ *  only the most recent block on the front can grow, up to the back.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+double_stack_try_resize_in_place(Double_Stack *ds,
+    Double_Stack_End end,
+    void            *old_ptr,
+    size_t           old_size,
+    size_t           new_size);
+
+
+/** @brief `ptr` must be the most recent live block on `end`. */
+void
+double_stack_free(Double_Stack *ds, Double_Stack_End end, void *ptr);
+
+
+/** @brief Free every block on `end`, leaving the other one alone. */
+void
+double_stack_free_all(Double_Stack *ds, Double_Stack_End end);
+
+
+/** @brief `ALLOCATOR_FREE_ALL` only resets `end`. */
+Allocator
+double_stack_allocator(Double_Stack *ds, Double_Stack_End end);
+
+#endif /* MEM_DOUBLE_STACK_H */
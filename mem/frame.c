@@ -0,0 +1,230 @@
+#include <string.h> // memset, memcpy
+
+#include "frame.h"
+
+void
+frame_allocator_init(Frame_Allocator *f,
+    void  *backing_buffer,
+    size_t backing_buffer_length,
+    size_t lifetime)
+{
+    assert(1 <= lifetime && lifetime <= MEM_FRAME_MAX_LIFETIME);
+    f->buf      = cast(unsigned char *)backing_buffer;
+    f->buf_len  = backing_buffer_length;
+    f->lifetime = lifetime;
+    f->frame    = 0;
+    frame_free_all(f);
+}
+
+void
+frame_free_all(Frame_Allocator *f)
+{
+    f->head = 0;
+    f->tail = 0;
+    for (size_t i = 0; i < f->lifetime; i += 1) {
+        f->starts[i] = 0;
+    }
+}
+
+void
+frame_allocator_advance(Frame_Allocator *f)
+{
+    f->frame += 1;
+    f->starts[f->frame % f->lifetime] = f->head;
+
+    // The oldest frame still alive is `frame - lifetime + 1`; the one before
+    // it is gone.
+    f->tail = f->starts[(f->frame + 1) % f->lifetime];
+}
+
+void *
+frame_alloc(Frame_Allocator *f, size_t size)
+{
+    return frame_alloc_align(f, size, MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+frame_alloc_align(Frame_Allocator *f, size_t size, size_t align)
+{
+    void *ptr = frame_alloc_align_non_zeroed(f, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+
+/** @brief Index of the first byte of a `size`-byte block aligned to `align`
+ *  at or after `offset`, if it ends at or before `limit`. */
+static bool
+internal_frame_fit(const Frame_Allocator *f,
+    size_t  offset,
+    size_t  limit,
+    size_t  size,
+    size_t  align,
+    size_t *start)
+{
+    uintptr_t base, user;
+
+    base = cast(uintptr_t)f->buf;
+    user = mem_align_forward(base + offset, align);
+    if (user > base + limit || base + limit - user < size) {
+        return false;
+    }
+    *start = cast(size_t)(user - base);
+    return true;
+}
+
+void *
+frame_alloc_align_non_zeroed(Frame_Allocator *f, size_t size, size_t align)
+{
+    size_t start;
+
+    assert(mem_is_power_of_two(align));
+    if (f->head == f->tail) {
+        // Nothing is alive, so every frame may as well start over at the
+        // beginning of the buffer.
+        frame_free_all(f);
+    }
+
+    if (f->head >= f->tail) {
+        // Free space is `[head, buf_len)`, then `[0, tail)`.
+        if (internal_frame_fit(f, f->head, f->buf_len, size, align, &start)) {
+            f->head = start + size;
+            return f->buf + start;
+        }
+        // Stop short of `tail`, else we could not tell a full buffer from
+        // an empty one.
+        if (f->tail > 0 && internal_frame_fit(f, 0, f->tail - 1, size, align, &start)) {
+            // The rest of the end is skipped, and recycled with this frame.
+            f->head = start + size;
+            return f->buf + start;
+        }
+    } else if (internal_frame_fit(f, f->head, f->tail - 1, size, align, &start)) {
+        f->head = start + size;
+        return f->buf + start;
+    }
+
+    // Out of memory!
+    return NULL;
+}
+
+void *
+frame_resize_align(Frame_Allocator *f,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *new_ptr;
+
+    new_ptr = frame_resize_align_non_zeroed(f, old_ptr, old_size, new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_ptr != NULL && old_size < new_size) {
+        memset(new_ptr + old_size, 0, new_size - old_size);
+    }
+    return new_ptr;
+}
+
+void *
+frame_resize_align_non_zeroed(Frame_Allocator *f,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    void *new_ptr;
+
+    if (old_ptr == NULL) {
+        return frame_alloc_align_non_zeroed(f, new_size, align);
+    } else if (new_size == 0) {
+        return NULL;
+    }
+
+    if ((cast(uintptr_t)old_ptr & (align - 1)) == 0
+        && frame_try_resize_in_place(f, old_ptr, old_size, new_size))
+    {
+        return old_ptr;
+    }
+
+    new_ptr = frame_alloc_align_non_zeroed(f, new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    return memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+}
+
+bool
+frame_try_resize_in_place(Frame_Allocator *f, void *old_ptr, size_t old_size, size_t new_size)
+{
+    size_t start, limit, current;
+
+    if (old_ptr == NULL) {
+        return false;
+    }
+
+    start = cast(size_t)(cast(unsigned char *)old_ptr - f->buf);
+    if (start + old_size != f->head) {
+        // Can only shrink, leaving the rest unused until its frame is gone.
+        return new_size <= old_size;
+    }
+
+    // The most recent allocation may still belong to an earlier frame, if
+    // the current one has not allocated yet. Growing it would hand the
+    // caller bytes that are recycled along with that older frame. If `head`
+    // is behind where the current frame began, the current frame wrapped
+    // around, and so did everything up to `head`.
+    current = f->starts[f->frame % f->lifetime];
+    if (start < current && f->head >= current) {
+        return new_size <= old_size;
+    }
+
+    // The most recent allocation may grow up to the end of the free space.
+    limit = (start >= f->tail) ? f->buf_len : f->tail - 1;
+    if (new_size > limit - start) {
+        return false;
+    }
+    f->head = start + new_size;
+    return true;
+}
+
+static void *
+frame_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Frame_Allocator *f = cast(Frame_Allocator *)context;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return frame_alloc_align(f, new_size, align);
+    case ALLOCATOR_RESIZE:
+        return frame_resize_align(f, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_FREE:
+        break;
+    case ALLOCATOR_FREE_ALL:
+        frame_free_all(f);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return frame_alloc_align_non_zeroed(f, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return frame_resize_align_non_zeroed(f, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (frame_try_resize_in_place(f, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+frame_allocator(Frame_Allocator *f)
+{
+    Allocator a = {frame_allocator_fn, f};
+    return a;
+}
@@ -0,0 +1,110 @@
+#ifndef MEM_FRAME_H
+#define MEM_FRAME_H
+
+#include "allocator.h"
+
+// Most frames an allocation may outlive the one it was made in by, plus 1.
+#ifndef MEM_FRAME_MAX_LIFETIME
+#define MEM_FRAME_MAX_LIFETIME  8
+#endif // MEM_FRAME_MAX_LIFETIME
+
+/**
+ * @brief Ring buffer of per-frame scratch memory. Everything allocated
+ *  during a frame stays valid for `lifetime` frames, counting that one, and
+ *  is then recycled by `frame_allocator_advance`. Memory use is bounded by
+ *  the buffer no matter how long the program runs.
+ *
+ * @note
+ *  Allocations are never freed individually. Requests fail once the frames
+ *  still alive fill the buffer, so size it for `lifetime` of the busiest
+ *  frames.
+ */
+typedef struct Frame_Allocator Frame_Allocator;
+struct Frame_Allocator {
+    unsigned char *buf;
+    size_t buf_len;
+
+    // Index one past the most recent allocation. Wraps back to the start of
+    // `buf` when the end runs out.
+    size_t head;
+
+    // Index of the first byte of the oldest frame still alive. `head == tail`
+    // only when nothing is allocated; requests never catch up to `tail`.
+    size_t tail;
+
+    // `starts[i % lifetime]` is where frame `i` began, for every frame that is
+    // still alive.
+    size_t starts[MEM_FRAME_MAX_LIFETIME];
+    size_t lifetime;
+
+    // Number of times `frame_allocator_advance` was called.
+    u64 frame;
+};
+
+
+/** @brief `lifetime` must be in `[1, MEM_FRAME_MAX_LIFETIME]`. With 1, memory
+ *  is only valid until the next call to `frame_allocator_advance`. */
+void
+frame_allocator_init(Frame_Allocator *f,
+    void  *backing_buffer,
+    size_t backing_buffer_length,
+    size_t lifetime);
+
+
+/** @brief End the current frame, recycling everything allocated `lifetime`
+ *  frames ago in O(1). */
+void
+frame_allocator_advance(Frame_Allocator *f);
+
+
+/** @brief Recycle every frame at once. */
+void
+frame_free_all(Frame_Allocator *f);
+
+void *
+frame_alloc(Frame_Allocator *f, size_t size);
+
+void *
+frame_alloc_align(Frame_Allocator *f, size_t size, size_t align);
+
+
+/** @brief Like `frame_alloc_align`, but the memory is not zeroed. */
+void *
+frame_alloc_align_non_zeroed(Frame_Allocator *f, size_t size, size_t align);
+
+
+/** @brief The most recent allocation of the current frame can be resized
+ *  in-place if there is room after it. Others are copied, the old block
+ *  staying valid until its frame is recycled. */
+void *
+frame_resize_align(Frame_Allocator *f,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+
+/** @brief Like `frame_resize_align`, but the growth region is not zeroed. */
+void *
+frame_resize_align_non_zeroed(Frame_Allocator *f,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+
+/** @brief Resize `old_ptr` without moving it. Any block can shrink, but only
+ *  the most recent allocation of the current frame can grow.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+frame_try_resize_in_place(Frame_Allocator *f, void *old_ptr, size_t old_size, size_t new_size);
+
+
+/** @brief `ALLOCATOR_FREE` does nothing; memory is recycled by
+ *  `frame_allocator_advance` only. */
+Allocator
+frame_allocator(Frame_Allocator *f);
+
+#endif /* MEM_FRAME_H */
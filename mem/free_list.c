@@ -0,0 +1,404 @@
+#include <string.h> // memset, memcpy
+
+#include "free_list.h"
+
+// Every block starts at, and spans a multiple of, this many bytes so that a
+// `Free_List_Node` can always be placed at the start of a freed block.
+#define FREE_LIST_BLOCK_ALIGNMENT   alignof(Free_List_Node)
+
+void
+free_list_init(Free_List *fl,
+    void            *backing_buffer,
+    size_t           backing_buffer_length,
+    Free_List_Policy policy)
+{
+    uintptr_t start, padding;
+
+    start   = mem_align_forward(cast(uintptr_t)backing_buffer, FREE_LIST_BLOCK_ALIGNMENT);
+    padding = start - cast(uintptr_t)backing_buffer;
+    if (padding > backing_buffer_length) {
+        padding = backing_buffer_length;
+    }
+
+    fl->buf     = cast(unsigned char *)backing_buffer + padding;
+    fl->buf_len = backing_buffer_length - padding;
+    fl->buf_len -= fl->buf_len % FREE_LIST_BLOCK_ALIGNMENT;
+    fl->policy  = policy;
+    free_list_free_all(fl);
+}
+
+void
+free_list_free_all(Free_List *fl)
+{
+    fl->used = 0;
+    if (fl->buf_len < sizeof(Free_List_Node)) {
+        fl->head = NULL;
+        return;
+    }
+    fl->head             = cast(Free_List_Node *)fl->buf;
+    fl->head->next       = NULL;
+    fl->head->block_size = fl->buf_len;
+}
+
+void *
+free_list_alloc(Free_List *fl, size_t size)
+{
+    return free_list_alloc_align(fl, size, MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+free_list_resize(Free_List *fl, void *old_ptr, size_t old_size, size_t new_size)
+{
+    return free_list_resize_align(fl, old_ptr, old_size, new_size,
+        MEM_DEFAULT_ALIGNMENT);
+}
+
+
+/** @brief Bytes from `block` to an address aligned to `align` with room for
+ *  an allocation header right before it. */
+static size_t
+internal_free_list_padding(uintptr_t block, size_t align)
+{
+    uintptr_t user = block + sizeof(Free_List_Allocation_Header);
+    return cast(size_t)(mem_align_forward(user, align) - block);
+}
+
+static size_t
+internal_free_list_round_size(size_t size)
+{
+    return cast(size_t)mem_align_forward(cast(uintptr_t)size, FREE_LIST_BLOCK_ALIGNMENT);
+}
+
+static Free_List_Allocation_Header *
+internal_free_list_header(void *ptr)
+{
+    return cast(Free_List_Allocation_Header *)ptr - 1;
+}
+
+
+/** @brief Find a free block with room for `size` bytes aligned to `align`.
+ *
+ * @param [out] prev_node  The node before the result, if any.
+ * @param [out] padding    Bytes from the block start to the user's pointer.
+ */
+static Free_List_Node *
+internal_free_list_find(Free_List *fl,
+    size_t           size,
+    size_t           align,
+    Free_List_Node **prev_node,
+    size_t          *padding)
+{
+    Free_List_Node *best      = NULL;
+    Free_List_Node *best_prev = NULL;
+    Free_List_Node *prev      = NULL;
+    size_t best_padding       = 0;
+    size_t best_leftover      = SIZE_MAX;
+
+    for (Free_List_Node *node = fl->head; node != NULL; prev = node, node = node->next) {
+        size_t pad, required;
+
+        pad      = internal_free_list_padding(cast(uintptr_t)node, align);
+        required = pad + size;
+        if (node->block_size < required) {
+            continue;
+        }
+
+        if (node->block_size - required < best_leftover) {
+            best          = node;
+            best_prev     = prev;
+            best_padding  = pad;
+            best_leftover = node->block_size - required;
+        }
+        if (fl->policy == FREE_LIST_POLICY_FIRST_FIT || best_leftover == 0) {
+            break;
+        }
+    }
+
+    *prev_node = best_prev;
+    *padding   = best_padding;
+    return best;
+}
+
+static void
+internal_free_list_unlink(Free_List *fl, Free_List_Node *prev, Free_List_Node *node)
+{
+    if (prev == NULL) {
+        fl->head = node->next;
+    } else {
+        prev->next = node->next;
+    }
+}
+
+
+/** @brief Take the first `size` bytes of the free `node`. If the rest is
+ *  big enough to hold a node, it stays on the free list in its place. */
+static size_t
+internal_free_list_take(Free_List *fl,
+    Free_List_Node *prev,
+    Free_List_Node *node,
+    size_t          size)
+{
+    size_t leftover = node->block_size - size;
+    if (leftover >= sizeof(Free_List_Node)) {
+        Free_List_Node *rest;
+
+        rest             = cast(Free_List_Node *)(cast(unsigned char *)node + size);
+        rest->next       = node->next;
+        rest->block_size = leftover;
+        if (prev == NULL) {
+            fl->head = rest;
+        } else {
+            prev->next = rest;
+        }
+        return size;
+    }
+
+    // Too small to track on its own, so the caller gets it all.
+    internal_free_list_unlink(fl, prev, node);
+    return node->block_size;
+}
+
+
+/** @brief Insert the block at `block` back into the address-sorted free list,
+ *  merging it with whichever neighbors are directly adjacent. */
+static void
+internal_free_list_insert(Free_List *fl, unsigned char *block, size_t block_size)
+{
+    Free_List_Node *node, *prev, *next;
+
+    prev = NULL;
+    next = fl->head;
+    while (next != NULL && cast(unsigned char *)next < block) {
+        prev = next;
+        next = next->next;
+    }
+
+    node             = cast(Free_List_Node *)block;
+    node->next       = next;
+    node->block_size = block_size;
+    if (prev == NULL) {
+        fl->head = node;
+    } else {
+        prev->next = node;
+    }
+
+    // Coalesce with the right neighbor?
+    if (next != NULL && block + node->block_size == cast(unsigned char *)next) {
+        node->block_size += next->block_size;
+        node->next        = next->next;
+    }
+
+    // Coalesce with the left neighbor?
+    if (prev != NULL && cast(unsigned char *)prev + prev->block_size == block) {
+        prev->block_size += node->block_size;
+        prev->next        = node->next;
+    }
+}
+
+void *
+free_list_alloc_align(Free_List *fl, size_t size, size_t align)
+{
+    void *ptr = free_list_alloc_align_non_zeroed(fl, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+free_list_alloc_align_non_zeroed(Free_List *fl, size_t size, size_t align)
+{
+    Free_List_Allocation_Header *header;
+    Free_List_Node *node, *prev;
+    unsigned char *user;
+    size_t padding, block_size;
+
+    // The header must be properly aligned as well.
+    if (align < alignof(Free_List_Allocation_Header)) {
+        align = alignof(Free_List_Allocation_Header);
+    }
+
+    node = internal_free_list_find(fl, internal_free_list_round_size(size), align,
+        &prev, &padding);
+    if (node == NULL) {
+        // Out of memory!
+        return NULL;
+    }
+
+    block_size = internal_free_list_take(fl, prev, node,
+        padding + internal_free_list_round_size(size));
+    fl->used  += block_size;
+
+    user               = cast(unsigned char *)node + padding;
+    header             = internal_free_list_header(user);
+    header->block_size = block_size;
+    header->padding    = padding;
+    return user;
+}
+
+void *
+free_list_resize_align(Free_List *fl,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *new_addr;
+
+    new_addr = free_list_resize_align_non_zeroed(fl, old_ptr, old_size,
+        new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_addr != NULL && old_size < new_size) {
+        memset(new_addr + old_size, 0, new_size - old_size);
+    }
+    return new_addr;
+}
+
+void *
+free_list_resize_align_non_zeroed(Free_List *fl,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *new_ptr;
+
+    if (old_ptr == NULL) {
+        return free_list_alloc_align_non_zeroed(fl, new_size, align);
+    } else if (new_size == 0) {
+        free_list_free(fl, old_ptr);
+        return NULL;
+    }
+
+    if (align < alignof(Free_List_Allocation_Header)) {
+        align = alignof(Free_List_Allocation_Header);
+    }
+
+    // Can only stay in-place if `old_ptr` already has the requested alignment.
+    if ((cast(uintptr_t)old_ptr & (align - 1)) == 0
+        && free_list_try_resize_in_place(fl, old_ptr, new_size))
+    {
+        return old_ptr;
+    }
+
+    new_ptr = cast(unsigned char *)free_list_alloc_align_non_zeroed(fl, new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+    free_list_free(fl, old_ptr);
+    return new_ptr;
+}
+
+bool
+free_list_try_resize_in_place(Free_List *fl, void *old_ptr, size_t new_size)
+{
+    Free_List_Allocation_Header *header;
+    unsigned char *block, *end;
+    Free_List_Node *prev, *node;
+    size_t required;
+
+    if (old_ptr == NULL) {
+        return false;
+    }
+
+    header   = internal_free_list_header(old_ptr);
+    block    = cast(unsigned char *)old_ptr - header->padding;
+    required = header->padding + internal_free_list_round_size(new_size);
+
+    if (required <= header->block_size) {
+        // Shrinking; give back the tail if it is big enough to track.
+        size_t leftover = header->block_size - required;
+        if (leftover >= sizeof(Free_List_Node)) {
+            internal_free_list_insert(fl, block + required, leftover);
+            header->block_size = required;
+            fl->used          -= leftover;
+        }
+        return true;
+    }
+
+    // Growing; is the block right after us free and big enough?
+    end  = block + header->block_size;
+    prev = NULL;
+    node = fl->head;
+    while (node != NULL && cast(unsigned char *)node < end) {
+        prev = node;
+        node = node->next;
+    }
+
+    if (cast(unsigned char *)node == end
+        && header->block_size + node->block_size >= required)
+    {
+        size_t taken;
+
+        taken = internal_free_list_take(fl, prev, node,
+            required - header->block_size);
+        header->block_size += taken;
+        fl->used           += taken;
+        return true;
+    }
+    return false;
+}
+
+void
+free_list_free(Free_List *fl, void *ptr)
+{
+    Free_List_Allocation_Header *header;
+    unsigned char *addr = cast(unsigned char *)ptr;
+
+    if (addr == NULL) {
+        return;
+    }
+
+    if (!(fl->buf <= addr && addr < fl->buf + fl->buf_len)) {
+        assert(0 && "Out of bounds memory address passed to free list allocator (free)");
+        return;
+    }
+
+    header    = internal_free_list_header(ptr);
+    fl->used -= header->block_size;
+    internal_free_list_insert(fl, addr - header->padding, header->block_size);
+}
+
+static void *
+free_list_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Free_List *fl = cast(Free_List *)context;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return free_list_alloc_align(fl, new_size, align);
+    case ALLOCATOR_RESIZE:
+        return free_list_resize_align(fl, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_FREE:
+        free_list_free(fl, old_ptr);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        free_list_free_all(fl);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return free_list_alloc_align_non_zeroed(fl, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return free_list_resize_align_non_zeroed(fl, old_ptr, old_size,
+            new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (free_list_try_resize_in_place(fl, old_ptr, new_size)) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+free_list_allocator(Free_List *fl)
+{
+    Allocator a = {free_list_allocator_fn, fl};
+    return a;
+}
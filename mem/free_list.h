@@ -0,0 +1,108 @@
+// https://www.gingerbill.org/article/2021/11/30/memory-allocation-strategies-005/
+#ifndef MEM_FREE_LIST_H
+#define MEM_FREE_LIST_H
+
+#include "allocator.h"
+
+typedef enum {
+    // Take the first free block that fits. Faster, but tends to fragment.
+    FREE_LIST_POLICY_FIRST_FIT,
+
+    // Take the free block that leaves the least space behind. Walks the
+    // entire free list on every allocation.
+    FREE_LIST_POLICY_BEST_FIT,
+} Free_List_Policy;
+
+// Lives right before the user's pointer.
+typedef struct Free_List_Allocation_Header Free_List_Allocation_Header;
+struct Free_List_Allocation_Header {
+    // Size of the whole block, including `padding`.
+    size_t block_size;
+
+    // Bytes from the start of the block to the user's pointer.
+    size_t padding;
+};
+
+// Lives at the start of each free block. Nodes are sorted by address so that
+// neighboring free blocks can be coalesced.
+typedef struct Free_List_Node Free_List_Node;
+struct Free_List_Node {
+    Free_List_Node *next;
+    size_t block_size;
+};
+
+typedef struct Free_List Free_List;
+struct Free_List {
+    unsigned char *buf;
+    size_t buf_len;
+
+    // Number of bytes currently handed out, including headers and padding.
+    size_t used;
+
+    Free_List_Node  *head;
+    Free_List_Policy policy;
+};
+
+void
+free_list_init(Free_List *fl,
+    void            *backing_buffer,
+    size_t           backing_buffer_length,
+    Free_List_Policy policy);
+
+void *
+free_list_alloc(Free_List *fl, size_t size);
+
+void *
+free_list_resize(Free_List *fl, void *old_ptr, size_t old_size, size_t new_size);
+
+
+/** @brief Resize `old_ptr` without moving it: shrink, or grow into the block
+ *  right after it if that one is free and big enough.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+free_list_try_resize_in_place(Free_List *fl, void *old_ptr, size_t new_size);
+
+
+/** @brief Return `ptr` to the free list, merging it with its free neighbors. */
+void
+free_list_free(Free_List *fl, void *ptr);
+
+
+/** @brief Turn the entire buffer back into a single free block. */
+void
+free_list_free_all(Free_List *fl);
+
+void *
+free_list_alloc_align(Free_List *fl, size_t size, size_t align);
+
+
+/** @brief Same as `free_list_alloc_align`, but the memory is not zeroed. */
+void *
+free_list_alloc_align_non_zeroed(Free_List *fl, size_t size, size_t align);
+
+
+/** @brief Shrink in-place, or grow in-place when the block right after
+ *  `old_ptr` is free and big enough. Otherwise move to a new block. */
+void *
+free_list_resize_align(Free_List *fl,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+
+/** @brief Same as `free_list_resize_align`, but the growth region is not
+ *  zeroed. */
+void *
+free_list_resize_align_non_zeroed(Free_List *fl,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align);
+
+Allocator
+free_list_allocator(Free_List *fl);
+
+#endif /* MEM_FREE_LIST_H */
@@ -0,0 +1,270 @@
+#include "growing_arena.h"
+
+void
+growing_arena_init(Growing_Arena *a, size_t block_size, Allocator backing)
+{
+    a->curr_block = NULL;
+    a->block_size = (block_size == 0) ? MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE : block_size;
+    a->backing    = backing;
+}
+
+static void
+internal_arena_block_release(Arena_Block *block, Allocator backing)
+{
+    mem_free(block, sizeof(*block) + block->arena.buf_len, backing);
+}
+
+void
+growing_arena_destroy(Growing_Arena *a)
+{
+    Arena_Block *block = a->curr_block;
+    while (block != NULL) {
+        Arena_Block *prev = block->prev;
+        internal_arena_block_release(block, a->backing);
+        block = prev;
+    }
+    a->curr_block = NULL;
+}
+
+
+/** @brief Push a new block that can fit at least `min_size` bytes. */
+static bool
+internal_growing_arena_push_block(Growing_Arena *a, size_t min_size)
+{
+    Arena_Block *block;
+    size_t buf_len;
+
+    buf_len = (min_size > a->block_size) ? min_size : a->block_size;
+    block   = cast(Arena_Block *)mem_alloc_align_non_zeroed(sizeof(*block) + buf_len,
+        alignof(Arena_Block), a->backing);
+    if (block == NULL) {
+        return false;
+    }
+
+    // The usable region starts right after the header.
+    arena_init(&block->arena, cast(void *)(block + 1), buf_len);
+    block->prev   = a->curr_block;
+    a->curr_block = block;
+    return true;
+}
+
+void *
+growing_arena_alloc(Growing_Arena *a, size_t size)
+{
+    return growing_arena_alloc_align(a, size, MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+growing_arena_alloc_align(Growing_Arena *a, size_t size, size_t align)
+{
+    void *ptr = growing_arena_alloc_align_non_zeroed(a, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+growing_arena_alloc_align_non_zeroed(Growing_Arena *a, size_t size, size_t align)
+{
+    void *ptr = NULL;
+
+    // Hot path: plain bump allocation in the current block.
+    if (a->curr_block != NULL) {
+        ptr = arena_alloc_align_non_zeroed(&a->curr_block->arena, size, align);
+        if (ptr != NULL) {
+            return ptr;
+        }
+    }
+
+    // Account for worst-case alignment padding in the new block.
+    if (!internal_growing_arena_push_block(a, size + align - 1)) {
+        return NULL;
+    }
+    return arena_alloc_align_non_zeroed(&a->curr_block->arena, size, align);
+}
+
+void *
+growing_arena_resize(Growing_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size)
+{
+    return growing_arena_resize_align(a, old_ptr, old_size, new_size,
+        MEM_DEFAULT_ALIGNMENT);
+}
+
+void *
+growing_arena_resize_align(Growing_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *new_addr;
+
+    new_addr = growing_arena_resize_align_non_zeroed(a, old_ptr, old_size,
+        new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_addr != NULL && old_size < new_size) {
+        memset(new_addr + old_size, 0, new_size - old_size);
+    }
+    return new_addr;
+}
+
+void *
+growing_arena_resize_align_non_zeroed(Growing_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size,
+    size_t align)
+{
+    unsigned char *old_addr = cast(unsigned char *)old_ptr;
+    void *new_ptr;
+    size_t copy_size;
+
+    // Requesting for a new block?
+    if (old_addr == NULL || (old_size == 0 && new_size > 0)) {
+        return growing_arena_alloc_align_non_zeroed(a, new_size, align);
+    }
+
+    // `old_ptr` lives in the current block? Let it try to resize in-place.
+    if (a->curr_block != NULL) {
+        Arena *curr = &a->curr_block->arena;
+        if (curr->buf <= old_addr && old_addr < curr->buf + curr->buf_len) {
+            new_ptr = arena_resize_align_non_zeroed(curr, old_ptr, old_size,
+                new_size, align);
+            if (new_ptr != NULL) {
+                return new_ptr;
+            }
+        }
+    }
+
+    // `old_ptr` lives in an older block, or the current block is full.
+    // Either way the old memory remains valid until the next free all.
+    new_ptr = growing_arena_alloc_align_non_zeroed(a, new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    copy_size = (old_size < new_size) ? old_size : new_size;
+    return memmove(new_ptr, old_ptr, copy_size);
+}
+
+bool
+growing_arena_try_resize_in_place(Growing_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size)
+{
+    unsigned char *old_addr = cast(unsigned char *)old_ptr;
+
+    // Only blocks in the current block can possibly grow.
+    if (a->curr_block != NULL && old_addr != NULL) {
+        Arena *curr = &a->curr_block->arena;
+        if (curr->buf <= old_addr && old_addr < curr->buf + curr->buf_len) {
+            return arena_try_resize_in_place(curr, old_ptr, old_size, new_size);
+        }
+    }
+    return old_addr != NULL && new_size <= old_size;
+}
+
+void
+growing_arena_free_all(Growing_Arena *a)
+{
+    Arena_Block *block = a->curr_block;
+    if (block == NULL) {
+        return;
+    }
+
+    // Keep only the most recent block as it is likely the biggest.
+    while (block->prev != NULL) {
+        Arena_Block *prev = block->prev;
+        block->prev = prev->prev;
+        internal_arena_block_release(prev, a->backing);
+    }
+    arena_free_all(&block->arena);
+}
+
+static void *
+growing_arena_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Growing_Arena *a = cast(Growing_Arena *)context;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return growing_arena_alloc_align(a, new_size, align);
+    case ALLOCATOR_RESIZE:
+        return growing_arena_resize_align(a, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_FREE:
+        break;
+    case ALLOCATOR_FREE_ALL:
+        growing_arena_free_all(a);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return growing_arena_alloc_align_non_zeroed(a, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return growing_arena_resize_align_non_zeroed(a, old_ptr, old_size,
+            new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (growing_arena_try_resize_in_place(a, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+growing_arena_allocator(Growing_Arena *a)
+{
+    Allocator r = {growing_arena_allocator_fn, a};
+    return r;
+}
+
+Temp_Growing_Arena_Memory
+temp_growing_arena_memory_begin(Growing_Arena *a)
+{
+    Temp_Growing_Arena_Memory temp;
+    temp.arena            = a;
+    temp.block            = a->curr_block;
+    temp.temp.arena       = NULL;
+    temp.temp.prev_offset = 0;
+    temp.temp.curr_offset = 0;
+    if (temp.block != NULL) {
+        temp.temp = temp_arena_memory_begin(&temp.block->arena);
+    }
+    return temp;
+}
+
+void
+temp_growing_arena_memory_end(Temp_Growing_Arena_Memory temp)
+{
+    Growing_Arena *a = temp.arena;
+
+    // Pop every block pushed within this scope.
+    while (a->curr_block != temp.block) {
+        Arena_Block *block = a->curr_block;
+
+        // `temp.block` is not in the chain; was the arena freed in between?
+        assert(block != NULL);
+
+        // The arena was empty when the scope began. Keep the first block
+        // around so that the next scope need not request it again.
+        if (temp.block == NULL && block->prev == NULL) {
+            arena_free_all(&block->arena);
+            return;
+        }
+        a->curr_block = block->prev;
+        internal_arena_block_release(block, a->backing);
+    }
+
+    if (temp.block != NULL) {
+        temp_arena_memory_end(temp.temp);
+    }
+}
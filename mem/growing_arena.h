@@ -0,0 +1,130 @@
+/**
+ * @link https://www.gingerbill.org/article/2019/02/08/memory-allocation-strategies-002/
+ */
+#ifndef MEM_GROWING_ARENA_H
+#define MEM_GROWING_ARENA_H
+
+#include "arena.h"
+
+#ifndef MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE
+#define MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE    (64 * 1024)
+#endif // MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE
+
+typedef struct Arena_Block Arena_Block;
+struct Arena_Block {
+    // The block that was in use before this one, if any.
+    Arena_Block *prev;
+
+    // Bump allocator over the bytes immediately following this header.
+    Arena arena;
+};
+
+typedef struct Growing_Arena Growing_Arena;
+struct Growing_Arena {
+    // The most recently pushed block. All allocations are served from here.
+    Arena_Block *curr_block;
+
+    // Minimum number of usable bytes in each new block.
+    size_t block_size;
+
+    // Where the blocks themselves are allocated from.
+    Allocator backing;
+};
+
+/** @brief Initialize the arena without allocating anything yet. The first
+ *  block is only requested from `backing` on the first allocation.
+ *
+ * @param block_size If 0, `MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE` is used.
+ */
+void
+growing_arena_init(Growing_Arena *a, size_t block_size, Allocator backing);
+
+
+/** @brief Return all blocks to the backing allocator. */
+void
+growing_arena_destroy(Growing_Arena *a);
+
+void *
+growing_arena_alloc(Growing_Arena *a, size_t size);
+
+
+/** @brief Bump-allocate from the current block. If it has no room left, a new
+ *  block of at least `block_size` bytes is pushed and we allocate from that.
+ *
+ * @return `NULL` only if the backing allocator fails.
+ */
+void *
+growing_arena_alloc_align(Growing_Arena *a, size_t size, size_t align);
+
+
+/** @brief Like `growing_arena_alloc_align`, but the memory is not zeroed. */
+void *
+growing_arena_alloc_align_non_zeroed(Growing_Arena *a, size_t size, size_t align);
+
+void *
+growing_arena_resize(Growing_Arena *a,
+    void                         *old_ptr,
+    size_t                        old_size,
+    size_t                        new_size);
+
+void *
+growing_arena_resize_align(Growing_Arena *a,
+    void                               *old_ptr,
+    size_t                              old_size,
+    size_t                              new_size,
+    size_t                              align);
+
+
+/** @brief Like `growing_arena_resize_align`, but the growth region is not
+ *  zeroed. */
+void *
+growing_arena_resize_align_non_zeroed(Growing_Arena *a,
+    void                                          *old_ptr,
+    size_t                                         old_size,
+    size_t                                         new_size,
+    size_t                                         align);
+
+
+/** @brief Resize `old_ptr` without moving it, which only the most recent
+ *  allocation of the current block can grow.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+growing_arena_try_resize_in_place(Growing_Arena *a,
+    void  *old_ptr,
+    size_t old_size,
+    size_t new_size);
+
+
+/** @brief Release all blocks but the current one, which is then reset. */
+void
+growing_arena_free_all(Growing_Arena *a);
+
+Allocator
+growing_arena_allocator(Growing_Arena *a);
+
+typedef struct Temp_Growing_Arena_Memory Temp_Growing_Arena_Memory;
+struct Temp_Growing_Arena_Memory {
+    Growing_Arena *arena;
+
+    // The block that was current when the scope began, if any.
+    Arena_Block *block;
+
+    // Offsets within `block`.
+    Temp_Arena_Memory temp;
+};
+
+
+/** @brief Save the current position of `a`. Scopes may be nested, but must be
+ *  ended in the reverse order that they were begun. */
+Temp_Growing_Arena_Memory
+temp_growing_arena_memory_begin(Growing_Arena *a);
+
+
+/** @brief Release the blocks pushed since `temp_growing_arena_memory_begin`
+ *  and restore the saved position in the block that was current then. */
+void
+temp_growing_arena_memory_end(Temp_Growing_Arena_Memory temp);
+
+#endif // MEM_GROWING_ARENA_H
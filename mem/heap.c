@@ -0,0 +1,58 @@
+#include <stdlib.h> // realloc, free
+#include <string.h> // memset
+
+#include "heap.h"
+
+static void *
+heap_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    // Not needed; the malloc family already tracks this for us.
+    unused(context);
+    unused(location);
+
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        old_ptr  = NULL;
+        old_size = 0;
+        // fallthrough
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED: {
+        void *new_ptr;
+        bool  zero;
+
+        assert(align <= MEM_DEFAULT_ALIGNMENT);
+        zero    = mode == ALLOCATOR_ALLOC || mode == ALLOCATOR_RESIZE;
+        new_ptr = realloc(old_ptr, new_size);
+        // Have a new region to zero out?
+        if (zero && new_ptr != NULL && old_size < new_size) {
+            size_t growth  = new_size - old_size;
+            char  *old_top = cast(char *)new_ptr + old_size;
+            memset(old_top, 0, growth);
+        }
+        return new_ptr;
+    }
+    case ALLOCATOR_FREE:
+        free(old_ptr);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        // `realloc` gives no way to forbid moving.
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+heap_allocator(void)
+{
+    Allocator a = {heap_allocator_fn, NULL};
+    return a;
+}
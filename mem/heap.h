@@ -0,0 +1,14 @@
+#ifndef MEM_HEAP_H
+#define MEM_HEAP_H
+
+#include "allocator.h"
+
+/** @brief An allocator backed by the C standard library's `realloc` and
+ *  `free`. It does not support `ALLOCATOR_FREE_ALL`.
+ *
+ * @note Alignments greater than `MEM_DEFAULT_ALIGNMENT` are not supported.
+ */
+Allocator
+heap_allocator(void);
+
+#endif /* MEM_HEAP_H */
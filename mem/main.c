@@ -3,6 +3,7 @@
 
 #include "allocator.c"
 #include "arena.c"
+#include "double_stack.c"
 #include "stack.c"
 
 #include <utils/strings.c>
@@ -41,14 +42,22 @@ main(void)
     // arena_init(&a, buf, sizeof(buf));
     // temp_allocator = arena_allocator(&a);
 
-    Stack s;
-    stack_init(&s, buf, sizeof(buf));
-    temp_allocator = stack_allocator(&s);
+    // Stack s;
+    // stack_init(&s, buf, sizeof(buf));
+    // temp_allocator = stack_allocator(&s);
+
+    // Lines live on the front, while the work done on them lives on the back,
+    // so neither needs its own fixed share of `buf`.
+    Double_Stack ds;
+    Allocator line_allocator;
+    double_stack_init(&ds, buf, sizeof(buf));
+    line_allocator = double_stack_allocator(&ds, DOUBLE_STACK_FRONT);
+    temp_allocator = double_stack_allocator(&ds, DOUBLE_STACK_BACK);
 
     for (;;) {
         printf(">");
 
-        String line = file_read_string(stdin, temp_allocator);
+        String line = file_read_string(stdin, line_allocator);
         if (line.data == NULL) {
             printf("\n");
             break;
@@ -63,11 +72,11 @@ main(void)
         String lol = string_concat(list, temp_allocator);
         printfln(STRING_FMTSPEC, string_expand(lol));
 
-        printfln("Before (%zu / %zu bytes)", s.curr_offset, s.buf_len);
+        printfln("Before (%zu / %zu bytes free)", double_stack_remaining(&ds), ds.buf_len);
         string_delete(lol, temp_allocator);
         array_delete(list.data, list.len, temp_allocator);
-        string_delete(line, temp_allocator);
-        printfln("After (%zu / %zu bytes)", s.curr_offset, s.buf_len);
+        string_delete(line, line_allocator);
+        printfln("After (%zu / %zu bytes free)", double_stack_remaining(&ds), ds.buf_len);
     }
     return 0;
 }
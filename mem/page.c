@@ -0,0 +1,258 @@
+#include <string.h> // memset, memcpy
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, mremap, madvise, munmap
+#include <unistd.h>   // sysconf
+#endif // POSIX
+
+#include "page.h"
+
+void
+page_allocator_init(Page_Allocator *p, size_t threshold, Allocator small)
+{
+    p->small     = small;
+    p->threshold = (threshold == 0) ? MEM_PAGE_DEFAULT_THRESHOLD : threshold;
+#ifdef MAP_ANONYMOUS
+    p->page_size = cast(size_t)sysconf(_SC_PAGESIZE);
+#else // !MAP_ANONYMOUS
+    p->page_size = 4096;
+#endif // MAP_ANONYMOUS
+}
+
+
+/** @brief Number of bytes actually mapped for a request of `size` bytes. */
+static size_t
+internal_page_length(const Page_Allocator *p, size_t size)
+{
+    if (size == 0) {
+        size = 1;
+    }
+    return cast(size_t)mem_align_forward(cast(uintptr_t)size, p->page_size);
+}
+
+static void
+internal_page_advise(void *ptr, size_t len)
+{
+#ifdef MADV_HUGEPAGE
+    // Only a hint; the kernel may ignore it, e.g. if THP are disabled.
+    if (len >= MEM_PAGE_HUGE_PAGE_SIZE) {
+        madvise(ptr, len, MADV_HUGEPAGE);
+    }
+#else // !MADV_HUGEPAGE
+    unused(ptr);
+    unused(len);
+#endif // MADV_HUGEPAGE
+}
+
+void *
+page_alloc(Page_Allocator *p, size_t size)
+{
+#ifdef MAP_ANONYMOUS
+    size_t len = internal_page_length(p, size);
+    void  *ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+        /*fd=*/-1, /*offset=*/0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    internal_page_advise(ptr, len);
+    return ptr;
+#else // !MAP_ANONYMOUS
+    unused(p);
+    unused(size);
+    return NULL;
+#endif // MAP_ANONYMOUS
+}
+
+void
+page_free(Page_Allocator *p, void *ptr, size_t size)
+{
+#ifdef MAP_ANONYMOUS
+    if (ptr != NULL) {
+        munmap(ptr, internal_page_length(p, size));
+    }
+#else // !MAP_ANONYMOUS
+    unused(p);
+    unused(ptr);
+    unused(size);
+#endif // MAP_ANONYMOUS
+}
+
+bool
+page_try_resize_in_place(Page_Allocator *p, void *old_ptr, size_t old_size, size_t new_size)
+{
+#ifdef MAP_ANONYMOUS
+    size_t old_len = internal_page_length(p, old_size);
+    size_t new_len = internal_page_length(p, new_size);
+
+    if (old_ptr == NULL) {
+        return false;
+    } else if (new_len <= old_len) {
+        // Give back whole pages we no longer need.
+        if (new_len < old_len) {
+            munmap(cast(unsigned char *)old_ptr + new_len, old_len - new_len);
+        }
+        return true;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    // Extend the mapping if the pages right after it are free.
+    if (mremap(old_ptr, old_len, new_len, /*flags=*/0) != MAP_FAILED) {
+        internal_page_advise(old_ptr, new_len);
+        return true;
+    }
+#endif // MREMAP_MAYMOVE
+    return false;
+#else // !MAP_ANONYMOUS
+    unused(p);
+    unused(old_ptr);
+    unused(old_size);
+    unused(new_size);
+    return false;
+#endif // MAP_ANONYMOUS
+}
+
+void *
+page_resize(Page_Allocator *p, void *old_ptr, size_t old_size, size_t new_size, bool zero)
+{
+    unsigned char *new_ptr;
+    size_t old_len;
+
+    if (old_ptr == NULL) {
+        return page_alloc(p, new_size);
+    } else if (new_size == 0) {
+        page_free(p, old_ptr, old_size);
+        return NULL;
+    }
+
+    old_len = internal_page_length(p, old_size);
+    if (page_try_resize_in_place(p, old_ptr, old_size, new_size)) {
+        new_ptr = cast(unsigned char *)old_ptr;
+    } else {
+#ifdef MREMAP_MAYMOVE
+        // The kernel moves the pages themselves; nothing is copied.
+        void *ptr = mremap(old_ptr, old_len, internal_page_length(p, new_size),
+            MREMAP_MAYMOVE);
+        if (ptr == MAP_FAILED) {
+            return NULL;
+        }
+        new_ptr = cast(unsigned char *)ptr;
+        internal_page_advise(new_ptr, internal_page_length(p, new_size));
+#else // !MREMAP_MAYMOVE
+        // Fresh pages are zero, so only the copied bytes matter.
+        new_ptr = cast(unsigned char *)page_alloc(p, new_size);
+        if (new_ptr == NULL) {
+            return NULL;
+        }
+        memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+        page_free(p, old_ptr, old_size);
+        return new_ptr;
+#endif // MREMAP_MAYMOVE
+    }
+
+    // Pages past `old_len` are fresh and thus already zero. Only the tail of
+    // the last old page may hold stale bytes, e.g. from a previous shrink.
+    if (zero && old_size < new_size) {
+        size_t dirty_end = (new_size < old_len) ? new_size : old_len;
+        memset(new_ptr + old_size, 0, dirty_end - old_size);
+    }
+    return new_ptr;
+}
+
+static bool
+internal_page_is_huge(const Page_Allocator *p, size_t size)
+{
+#ifdef MAP_ANONYMOUS
+    return size >= p->threshold;
+#else // !MAP_ANONYMOUS
+    unused(p);
+    unused(size);
+    return false;
+#endif // MAP_ANONYMOUS
+}
+
+static void *
+page_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Page_Allocator *p = cast(Page_Allocator *)context;
+    bool old_huge, new_huge, zero;
+    unsigned char *new_ptr;
+
+    old_huge = old_ptr != NULL && internal_page_is_huge(p, old_size);
+    new_huge = internal_page_is_huge(p, new_size);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        if (!new_huge) {
+            break;
+        }
+        assert(align <= p->page_size);
+        return page_alloc(p, new_size);
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        zero = mode == ALLOCATOR_RESIZE;
+        if (!old_huge && !new_huge) {
+            break;
+        } else if (old_huge && (new_huge || new_size == 0)) {
+            return page_resize(p, old_ptr, old_size, new_size, zero);
+        } else if (old_ptr == NULL) {
+            return page_alloc(p, new_size);
+        }
+
+        // Crossing `threshold` in either direction; the block changes owners.
+        if (new_huge) {
+            new_ptr = cast(unsigned char *)page_alloc(p, new_size);
+        } else {
+            new_ptr = cast(unsigned char *)mem_alloc_align_non_zeroed_loc(new_size,
+                align, p->small, location);
+        }
+        if (new_ptr == NULL) {
+            return NULL;
+        }
+        memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+        // Fresh pages are already zero.
+        if (zero && !new_huge && old_size < new_size) {
+            memset(new_ptr + old_size, 0, new_size - old_size);
+        }
+        if (old_huge) {
+            page_free(p, old_ptr, old_size);
+        } else {
+            mem_free_loc(old_ptr, old_size, p->small, location);
+        }
+        return new_ptr;
+    case ALLOCATOR_FREE:
+        if (!old_huge) {
+            break;
+        }
+        page_free(p, old_ptr, old_size);
+        return NULL;
+    case ALLOCATOR_FREE_ALL:
+        // Mappings are not tracked; their owners must free them.
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (!old_huge && !new_huge) {
+            break;
+        } else if (old_huge && new_huge
+            && page_try_resize_in_place(p, old_ptr, old_size, new_size))
+        {
+            return old_ptr;
+        }
+        return NULL;
+    }
+
+    // Not huge; let `small` handle it.
+    return p->small.fn(p->small.context, mode, old_ptr, old_size, new_size,
+        align, location);
+}
+
+Allocator
+page_allocator(Page_Allocator *p)
+{
+    Allocator a = {page_allocator_fn, p};
+    return a;
+}
@@ -0,0 +1,76 @@
+#ifndef MEM_PAGE_H
+#define MEM_PAGE_H
+
+#include "allocator.h"
+
+// Requests of at least this many bytes are mapped directly from the OS.
+#ifndef MEM_PAGE_DEFAULT_THRESHOLD
+#define MEM_PAGE_DEFAULT_THRESHOLD  (1024 * 1024)
+#endif // MEM_PAGE_DEFAULT_THRESHOLD
+
+// Mappings of at least this many bytes are hinted to use transparent huge
+// pages, where supported.
+#ifndef MEM_PAGE_HUGE_PAGE_SIZE
+#define MEM_PAGE_HUGE_PAGE_SIZE     (2 * 1024 * 1024)
+#endif // MEM_PAGE_HUGE_PAGE_SIZE
+
+/**
+ * @brief Serves huge requests straight from `mmap`, and forwards everything
+ *  else to another allocator.
+ *
+ * @note
+ *  `mmap` needs `_DEFAULT_SOURCE` under `-std=c11` on glibc, and `mremap` and
+ *  `MADV_HUGEPAGE` need `_GNU_SOURCE`. Define it before including any other
+ *  header. Without `mremap`, growing maps anew and copies. Without `mmap`
+ *  at all, every request goes to `small`.
+ *
+ *  Alignments greater than the OS page size are not supported.
+ */
+typedef struct Page_Allocator Page_Allocator;
+struct Page_Allocator {
+    // Serves requests of less than `threshold` bytes.
+    Allocator small;
+    size_t    threshold;
+
+    // Queried once from the OS by `page_allocator_init`.
+    size_t    page_size;
+};
+
+
+/** @brief Zero `threshold` to use the default. */
+void
+page_allocator_init(Page_Allocator *p, size_t threshold, Allocator small);
+
+
+/** @brief Map `size` bytes, rounded up to whole pages. The memory is always
+ *  zeroed, as fresh anonymous pages are.
+ *
+ * @return `NULL` if the mapping failed.
+ */
+void *
+page_alloc(Page_Allocator *p, size_t size);
+
+
+/** @brief Resize a mapping made by `page_alloc`. Uses `mremap` where
+ *  available, so growing may move the pages instead of copying them.
+ *
+ * @param zero  Whether to zero `[old_size, new_size)`.
+ */
+void *
+page_resize(Page_Allocator *p, void *old_ptr, size_t old_size, size_t new_size, bool zero);
+
+
+/** @brief Like `page_resize`, but never moves `old_ptr`.
+ *
+ * @return `false` if it would have to move, leaving the mapping untouched.
+ */
+bool
+page_try_resize_in_place(Page_Allocator *p, void *old_ptr, size_t old_size, size_t new_size);
+
+void
+page_free(Page_Allocator *p, void *ptr, size_t size);
+
+Allocator
+page_allocator(Page_Allocator *p);
+
+#endif /* MEM_PAGE_H */
@@ -0,0 +1,279 @@
+#include <string.h> // memset
+
+#include "pool.h"
+
+static void
+internal_pool_init(Pool *p, size_t chunk_size, size_t chunk_align)
+{
+    assert(mem_is_power_of_two(chunk_align));
+
+    // Free chunks must be able to hold (and be aligned for) a free list node.
+    if (chunk_align < alignof(Pool_Free_Node)) {
+        chunk_align = alignof(Pool_Free_Node);
+    }
+    if (chunk_size < sizeof(Pool_Free_Node)) {
+        chunk_size = sizeof(Pool_Free_Node);
+    }
+
+    // Each chunk must start at an aligned address.
+    p->chunk_size  = cast(size_t)mem_align_forward(cast(uintptr_t)chunk_size, chunk_align);
+    p->chunk_align = chunk_align;
+    p->head        = NULL;
+    p->bump        = NULL;
+    p->bump_end    = NULL;
+    p->blocks      = NULL;
+    p->next_block  = NULL;
+}
+
+
+/** @brief Carve chunks out of `region` from now on. */
+static void
+internal_pool_set_region(Pool *p, unsigned char *region, size_t region_len)
+{
+    uintptr_t start;
+    size_t padding;
+
+    start   = mem_align_forward(cast(uintptr_t)region, p->chunk_align);
+    padding = cast(size_t)(start - cast(uintptr_t)region);
+    if (padding >= region_len) {
+        p->bump     = NULL;
+        p->bump_end = NULL;
+        return;
+    }
+    p->bump     = region + padding;
+    p->bump_end = region + region_len;
+}
+
+void
+pool_init(Pool *p,
+    void  *backing_buffer,
+    size_t backing_buffer_length,
+    size_t chunk_size,
+    size_t chunk_align)
+{
+    internal_pool_init(p, chunk_size, chunk_align);
+    p->buf               = cast(unsigned char *)backing_buffer;
+    p->buf_len           = backing_buffer_length;
+    p->backing.fn        = NULL;
+    p->backing.context   = NULL;
+    p->block_chunk_count = 0;
+    pool_free_all(p);
+}
+
+void
+pool_init_growing(Pool *p,
+    size_t    chunk_size,
+    size_t    chunk_align,
+    size_t    chunk_count,
+    Allocator backing)
+{
+    internal_pool_init(p, chunk_size, chunk_align);
+    p->buf               = NULL;
+    p->buf_len           = 0;
+    p->backing           = backing;
+    p->block_chunk_count = (chunk_count == 0) ? 1 : chunk_count;
+}
+
+void
+pool_destroy(Pool *p)
+{
+    Pool_Block *block = p->blocks;
+    while (block != NULL) {
+        Pool_Block *next = block->next;
+        mem_free(block, sizeof(*block) + block->len, p->backing);
+        block = next;
+    }
+    p->blocks = NULL;
+    pool_free_all(p);
+}
+
+static bool
+internal_pool_push_block(Pool *p)
+{
+    Pool_Block *block;
+    size_t len;
+
+    if (p->backing.fn == NULL) {
+        return false;
+    }
+
+    // Leave room to align the first chunk.
+    len   = p->chunk_align - 1 + p->block_chunk_count * p->chunk_size;
+    block = cast(Pool_Block *)mem_alloc_align_non_zeroed(sizeof(*block) + len,
+        alignof(Pool_Block), p->backing);
+    if (block == NULL) {
+        return false;
+    }
+
+    // Only called once every other block is used up, so `next_block` stays
+    // `NULL`.
+    block->next = p->blocks;
+    block->len  = len;
+    p->blocks   = block;
+    internal_pool_set_region(p, cast(unsigned char *)(block + 1), len);
+    return true;
+}
+
+
+/** @brief Take a chunk that was never handed out since the last reset. */
+static void *
+internal_pool_carve(Pool *p)
+{
+    for (;;) {
+        if (p->bump != NULL
+            && cast(size_t)(p->bump_end - p->bump) >= p->chunk_size)
+        {
+            void *ptr = p->bump;
+            p->bump  += p->chunk_size;
+            return ptr;
+        }
+
+        if (p->next_block != NULL) {
+            Pool_Block *block = p->next_block;
+            p->next_block = block->next;
+            internal_pool_set_region(p, cast(unsigned char *)(block + 1), block->len);
+        } else if (!internal_pool_push_block(p)) {
+            // Out of memory!
+            return NULL;
+        }
+    }
+}
+
+void *
+pool_alloc(Pool *p)
+{
+    void *ptr = pool_alloc_non_zeroed(p);
+    if (ptr != NULL) {
+        memset(ptr, 0, p->chunk_size);
+    }
+    return ptr;
+}
+
+void *
+pool_alloc_non_zeroed(Pool *p)
+{
+    Pool_Free_Node *node = p->head;
+    if (node == NULL) {
+        return internal_pool_carve(p);
+    }
+    p->head = node->next;
+    return node;
+}
+
+void
+pool_free(Pool *p, void *ptr)
+{
+    Pool_Free_Node *node;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    // Blocks of growable pools are not tracked by address, so we can only
+    // check pools with a fixed buffer.
+    if (p->blocks == NULL) {
+        unsigned char *addr = cast(unsigned char *)ptr;
+        if (!(p->buf <= addr && addr < p->buf + p->buf_len)) {
+            assert(0 && "Out of bounds memory address passed to pool allocator (free)");
+            return;
+        }
+    }
+
+    node       = cast(Pool_Free_Node *)ptr;
+    node->next = p->head;
+    p->head    = node;
+}
+
+bool
+pool_owns(const Pool *p, const void *ptr)
+{
+    uintptr_t addr = cast(uintptr_t)ptr;
+
+    if (p->buf != NULL && cast(uintptr_t)p->buf <= addr
+        && addr < cast(uintptr_t)(p->buf + p->buf_len))
+    {
+        return true;
+    }
+    for (const Pool_Block *block = p->blocks; block != NULL; block = block->next) {
+        uintptr_t start = cast(uintptr_t)(block + 1);
+        if (start <= addr && addr < start + block->len) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+pool_free_all(Pool *p)
+{
+    p->head       = NULL;
+    p->next_block = p->blocks;
+    if (p->buf != NULL) {
+        internal_pool_set_region(p, p->buf, p->buf_len);
+    } else {
+        p->bump     = NULL;
+        p->bump_end = NULL;
+    }
+}
+
+static bool
+internal_pool_fits(const Pool *p, size_t size, size_t align)
+{
+    return size <= p->chunk_size && align <= p->chunk_align;
+}
+
+static void *
+pool_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Pool *p = cast(Pool *)context;
+    unused(location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        if (!internal_pool_fits(p, new_size, align)) {
+            return NULL;
+        }
+        return (mode == ALLOCATOR_ALLOC) ? pool_alloc(p) : pool_alloc_non_zeroed(p);
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        if (!internal_pool_fits(p, new_size, align)) {
+            return NULL;
+        } else if (old_ptr == NULL) {
+            return (mode == ALLOCATOR_RESIZE) ? pool_alloc(p) : pool_alloc_non_zeroed(p);
+        } else if (new_size == 0) {
+            pool_free(p, old_ptr);
+            return NULL;
+        }
+
+        // Still fits in the same chunk, so it is always in-place.
+        if (mode == ALLOCATOR_RESIZE && old_size < new_size) {
+            memset(cast(unsigned char *)old_ptr + old_size, 0, new_size - old_size);
+        }
+        return old_ptr;
+    case ALLOCATOR_FREE:
+        pool_free(p, old_ptr);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        pool_free_all(p);
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (old_ptr != NULL && new_size <= p->chunk_size) {
+            return old_ptr;
+        }
+        break;
+    }
+    return NULL;
+}
+
+Allocator
+pool_allocator(Pool *p)
+{
+    Allocator a = {pool_allocator_fn, p};
+    return a;
+}
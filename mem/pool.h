@@ -0,0 +1,116 @@
+// https://www.gingerbill.org/article/2019/02/16/memory-allocation-strategies-004/
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include "allocator.h"
+
+// Free chunks store the free list inside themselves, so there is no
+// per-chunk header overhead.
+typedef struct Pool_Free_Node Pool_Free_Node;
+struct Pool_Free_Node {
+    Pool_Free_Node *next;
+};
+
+// Header of each extra block of chunks requested by a growable pool.
+typedef struct Pool_Block Pool_Block;
+struct Pool_Block {
+    Pool_Block *next;
+
+    // Number of bytes following this header, including alignment padding.
+    size_t len;
+};
+
+typedef struct Pool Pool;
+struct Pool {
+    // The fixed backing buffer, if any.
+    unsigned char *buf;
+    size_t buf_len;
+
+    // Size of each chunk, already rounded up to `chunk_align`.
+    size_t chunk_size;
+    size_t chunk_align;
+
+    // The most recently freed chunk, if any.
+    Pool_Free_Node *head;
+
+    // Chunks that were never handed out since the last reset. They are
+    // carved off one at a time once `head` runs out, so resetting the pool
+    // does not have to touch every chunk.
+    unsigned char *bump;
+    unsigned char *bump_end;
+
+    // Growable pools only. When `head` runs out, a new block of
+    // `block_chunk_count` chunks is requested from `backing`.
+    Allocator   backing;
+    size_t      block_chunk_count;
+    Pool_Block *blocks;
+
+    // The next block in `blocks` to carve from once `bump` runs out.
+    Pool_Block *next_block;
+};
+
+
+/** @brief Carve `backing_buffer` into chunks of `chunk_size` bytes. The pool
+ *  never grows past it. */
+void
+pool_init(Pool *p,
+    void  *backing_buffer,
+    size_t backing_buffer_length,
+    size_t chunk_size,
+    size_t chunk_align);
+
+
+/** @brief Start with no chunks at all. Each time the free list runs out,
+ *  `chunk_count` more chunks are requested from `backing` at once, e.g. a
+ *  `Growing_Arena`. */
+void
+pool_init_growing(Pool *p,
+    size_t    chunk_size,
+    size_t    chunk_align,
+    size_t    chunk_count,
+    Allocator backing);
+
+
+/** @brief Return all blocks requested by a growable pool to its backing
+ *  allocator. */
+void
+pool_destroy(Pool *p);
+
+
+/** @brief Pop a zeroed chunk off the free list in O(1).
+ *
+ * @return `NULL` if out of chunks and the pool cannot grow.
+ */
+void *
+pool_alloc(Pool *p);
+
+
+/** @brief Like `pool_alloc`, but the chunk is not zeroed. */
+void *
+pool_alloc_non_zeroed(Pool *p);
+
+
+/** @brief Push `ptr` back onto the free list in O(1). */
+void
+pool_free(Pool *p, void *ptr);
+
+
+/** @brief Whether `ptr` points into the fixed buffer or any block of `p`.
+ *  Walks every block, so it is O(blocks) rather than O(1). */
+bool
+pool_owns(const Pool *p, const void *ptr);
+
+
+/** @brief Make every chunk available again in O(1) per block. Growable
+ *  pools keep their blocks. */
+void
+pool_free_all(Pool *p);
+
+
+/** @brief Requests must fit in `chunk_size` bytes and `chunk_align`
+ *  alignment, else they fail. Resizing only succeeds while the new size
+ *  still fits in the same chunk. */
+Allocator
+pool_allocator(Pool *p);
+
+#endif /* MEM_POOL_H */
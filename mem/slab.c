@@ -0,0 +1,285 @@
+#include <string.h> // memset, memcpy
+
+#include "slab.h"
+
+// Maps `(size + 15) / 16` to the index of the smallest class that fits
+// `size` bytes, so finding the class takes a single load.
+static const unsigned char
+internal_slab_class_table[MEM_SLAB_MAX_SIZE / MEM_SLAB_MIN_SIZE + 1] = {
+    0, 0,           // [0, 16]
+    1,              // [17, 32]
+    2, 2,           // [33, 64]
+    3, 3, 3, 3,     // [65, 128]
+    4, 4, 4, 4, 4, 4, 4, 4, // [129, 256]
+};
+
+static size_t
+internal_slab_class_size(size_t class_index)
+{
+    return cast(size_t)MEM_SLAB_MIN_SIZE << class_index;
+}
+
+void
+slab_init(Slab *s, Allocator backing)
+{
+    s->backing = backing;
+    for (size_t i = 0; i < MEM_SLAB_CLASS_COUNT; i += 1) {
+        // Chunks are packed back to back, so aligning them to their own
+        // size only costs some padding before the first chunk of each block.
+        size_t size = internal_slab_class_size(i);
+        pool_init_growing(&s->classes[i], size, size, MEM_SLAB_BLOCK_SIZE / size,
+            backing);
+    }
+    s->foreign_count = 0;
+}
+
+void
+slab_destroy(Slab *s)
+{
+    for (size_t i = 0; i < MEM_SLAB_CLASS_COUNT; i += 1) {
+        pool_destroy(&s->classes[i]);
+    }
+}
+
+void
+slab_free_all(Slab *s)
+{
+    for (size_t i = 0; i < MEM_SLAB_CLASS_COUNT; i += 1) {
+        pool_free_all(&s->classes[i]);
+    }
+}
+
+
+/** @brief The class of `size` bytes, or `NULL` if it is too big for any. */
+static Pool *
+internal_slab_class(Slab *s, size_t size)
+{
+    if (size > MEM_SLAB_MAX_SIZE) {
+        return NULL;
+    }
+    return &s->classes[internal_slab_class_table[(size + MEM_SLAB_MIN_SIZE - 1) / MEM_SLAB_MIN_SIZE]];
+}
+
+
+/** @brief The pool serving `size` bytes aligned to `align`, or `NULL` if it
+ *  is up to the backing allocator. */
+static Pool *
+internal_slab_pool(Slab *s, size_t size, size_t align)
+{
+    Pool *p = internal_slab_class(s, size);
+    return (p != NULL && align <= p->chunk_align) ? p : NULL;
+}
+
+
+/** @brief The pool that `ptr`, last allocated or resized to `size` bytes,
+ *  came from, or `NULL` if it came from the backing allocator. */
+static Pool *
+internal_slab_owner(Slab *s, void *ptr, size_t size)
+{
+    Pool *p = internal_slab_class(s, size);
+    if (ptr == NULL || p == NULL) {
+        return NULL;
+    }
+    return (s->foreign_count == 0 || pool_owns(p, ptr)) ? p : NULL;
+}
+
+
+/** @brief Count a block of `size` bytes from the backing allocator coming to
+ *  life or going away, if it could be mistaken for a chunk. */
+static void
+internal_slab_track(Slab *s, size_t size, bool live)
+{
+    if (size > MEM_SLAB_MAX_SIZE) {
+        return;
+    } else if (live) {
+        s->foreign_count += 1;
+    } else {
+        assert(s->foreign_count > 0);
+        s->foreign_count -= 1;
+    }
+}
+
+void *
+slab_alloc(Slab *s, size_t size)
+{
+    void *ptr = slab_alloc_non_zeroed(s, size);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+slab_alloc_non_zeroed(Slab *s, size_t size)
+{
+    // Every class is aligned to at least `MEM_DEFAULT_ALIGNMENT`, so only
+    // big requests go to the backing allocator.
+    Pool *p = internal_slab_pool(s, size, MEM_DEFAULT_ALIGNMENT);
+    if (p == NULL) {
+        return mem_alloc_non_zeroed(size, s->backing);
+    }
+    return pool_alloc_non_zeroed(p);
+}
+
+void
+slab_free(Slab *s, void *ptr, size_t size)
+{
+    Pool *p;
+
+    if (ptr == NULL) {
+        return;
+    }
+    p = internal_slab_owner(s, ptr, size);
+    if (p == NULL) {
+        mem_free(ptr, size, s->backing);
+        internal_slab_track(s, size, false);
+    } else {
+        pool_free(p, ptr);
+    }
+}
+
+
+/** @brief Forward a request to the backing allocator, keeping
+ *  `foreign_count` up to date. */
+static void *
+internal_slab_forward(Slab *s,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    void *new_ptr;
+    bool old_gone = false, new_live = false;
+
+    new_ptr = s->backing.fn(s->backing.context, mode, old_ptr, old_size, new_size,
+        align, location);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        new_live = new_ptr != NULL;
+        break;
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        // A failed resize leaves the old block as is.
+        old_gone = old_ptr != NULL && (new_size == 0 || new_ptr != NULL);
+        new_live = new_ptr != NULL;
+        break;
+    case ALLOCATOR_FREE:
+        old_gone = old_ptr != NULL;
+        break;
+    case ALLOCATOR_FREE_ALL:
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        old_gone = old_ptr != NULL && new_ptr == old_ptr;
+        new_live = old_gone;
+        break;
+    }
+
+    if (old_gone) {
+        internal_slab_track(s, old_size, false);
+    }
+    if (new_live) {
+        internal_slab_track(s, new_size, true);
+    }
+    return new_ptr;
+}
+
+static void *
+slab_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Slab *s = cast(Slab *)context;
+    Pool *old_pool, *new_pool;
+    unsigned char *new_ptr;
+
+    // Frees and in-place resizes pass `align == 0`, so the pool of `old_ptr`
+    // is decided by its address instead.
+    old_pool = internal_slab_owner(s, old_ptr, old_size);
+    new_pool = internal_slab_pool(s, new_size, align);
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        if (new_pool == NULL) {
+            break;
+        }
+        return (mode == ALLOCATOR_ALLOC) ? pool_alloc(new_pool)
+            : pool_alloc_non_zeroed(new_pool);
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        if (old_ptr != NULL && new_size == 0) {
+            if (old_pool == NULL) {
+                break;
+            }
+            pool_free(old_pool, old_ptr);
+            return NULL;
+        }
+
+        if (old_pool == NULL && new_pool == NULL) {
+            break;
+        } else if (old_pool != NULL && old_pool == new_pool) {
+            // Same class, so the chunk already has room.
+            new_ptr = cast(unsigned char *)old_ptr;
+        } else {
+            if (new_pool == NULL) {
+                new_ptr = cast(unsigned char *)internal_slab_forward(s,
+                    ALLOCATOR_ALLOC_NON_ZEROED, NULL, 0, new_size, align, location);
+            } else {
+                new_ptr = cast(unsigned char *)pool_alloc_non_zeroed(new_pool);
+            }
+            if (new_ptr == NULL) {
+                return NULL;
+            }
+            if (old_ptr != NULL) {
+                memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+                if (old_pool == NULL) {
+                    internal_slab_forward(s, ALLOCATOR_FREE, old_ptr, old_size, 0, 0,
+                        location);
+                } else {
+                    pool_free(old_pool, old_ptr);
+                }
+            } else {
+                old_size = 0;
+            }
+        }
+        if (mode == ALLOCATOR_RESIZE && old_size < new_size) {
+            memset(new_ptr + old_size, 0, new_size - old_size);
+        }
+        return new_ptr;
+    case ALLOCATOR_FREE:
+        if (old_ptr == NULL) {
+            return NULL;
+        } else if (old_pool == NULL) {
+            break;
+        }
+        pool_free(old_pool, old_ptr);
+        return NULL;
+    case ALLOCATOR_FREE_ALL:
+        slab_free_all(s);
+        return NULL;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (old_pool == NULL && new_pool == NULL) {
+            break;
+        } else if (old_pool != NULL && old_pool == new_pool) {
+            return old_ptr;
+        }
+        return NULL;
+    }
+
+    // Too big or too aligned for any class.
+    return internal_slab_forward(s, mode, old_ptr, old_size, new_size, align,
+        location);
+}
+
+Allocator
+slab_allocator(Slab *s)
+{
+    Allocator a = {slab_allocator_fn, s};
+    return a;
+}
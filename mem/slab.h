@@ -0,0 +1,74 @@
+#ifndef MEM_SLAB_H
+#define MEM_SLAB_H
+
+#include "pool.h"
+
+// Size classes are the powers of 2 from `MEM_SLAB_MIN_SIZE` up to
+// `MEM_SLAB_MAX_SIZE` bytes. Bigger requests go straight to the backing
+// allocator.
+#define MEM_SLAB_MIN_SIZE       16
+#define MEM_SLAB_MAX_SIZE       256
+#define MEM_SLAB_CLASS_COUNT    5
+
+// Each class requests chunks from the backing allocator this many bytes at
+// a time.
+#ifndef MEM_SLAB_BLOCK_SIZE
+#define MEM_SLAB_BLOCK_SIZE     (16 * 1024)
+#endif // MEM_SLAB_BLOCK_SIZE
+
+/**
+ * @brief Serves small requests from one growable `Pool` per size class, so
+ *  allocating and freeing is a free list pop and push, and objects of the
+ *  same size end up packed together.
+ *
+ * @note
+ *  The class of a block is derived from the size the caller passes in, so
+ *  frees and resizes must pass the same size as the block was last
+ *  allocated or resized with. Chunks are aligned to their class size, so
+ *  only requests aligned to more than that leave their class.
+ */
+typedef struct Slab Slab;
+struct Slab {
+    Pool classes[MEM_SLAB_CLASS_COUNT];
+
+    // Holds the blocks of every class, and serves requests bigger than
+    // `MEM_SLAB_MAX_SIZE` bytes or aligned to more than their class.
+    Allocator backing;
+
+    // Live blocks of at most `MEM_SLAB_MAX_SIZE` bytes that were served by
+    // `backing` for being too aligned. Frees and resizes do not pass the
+    // alignment, so while there are any, small blocks are looked up in their
+    // class by address to tell the two apart.
+    size_t foreign_count;
+};
+
+void
+slab_init(Slab *s, Allocator backing);
+
+
+/** @brief Return the blocks of every class to the backing allocator. Big
+ *  requests served by it directly must be freed individually beforehand. */
+void
+slab_destroy(Slab *s);
+
+
+/** @brief Put every chunk of every class back onto its free list. Big
+ *  requests served by the backing allocator are left alone. */
+void
+slab_free_all(Slab *s);
+
+void *
+slab_alloc(Slab *s, size_t size);
+
+
+/** @brief Like `slab_alloc`, but the memory is not zeroed. */
+void *
+slab_alloc_non_zeroed(Slab *s, size_t size);
+
+void
+slab_free(Slab *s, void *ptr, size_t size);
+
+Allocator
+slab_allocator(Slab *s);
+
+#endif /* MEM_SLAB_H */
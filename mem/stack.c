@@ -65,6 +65,16 @@ calc_padding_with_header(uintptr_t ptr, uintptr_t align)
 
 void *
 stack_alloc_align(Stack *s, size_t size, size_t align)
+{
+    void *ptr = stack_alloc_align_non_zeroed(s, size, align);
+    if (ptr != NULL) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void *
+stack_alloc_align_non_zeroed(Stack *s, size_t size, size_t align)
 {
     /*
     |prev=0,   padding=16|"hi mom lol"|prev=0,   padding=16|[]string|
@@ -96,9 +106,9 @@ stack_alloc_align(Stack *s, size_t size, size_t align)
     header->padding = padding;
 
     // Save index of the this allocation's header as the top of the chain.
-    s->prev_offset  = s->curr_offset;
+    s->prev_offset  = cast(size_t)(cast(uintptr_t)header - cast(uintptr_t)s->buf);
     s->curr_offset += padding + size;
-    return memset(cast(void *)next_addr, 0, size);
+    return cast(void *)next_addr;
 }
 
 void *
@@ -107,17 +117,32 @@ stack_resize_align(Stack *s,
     size_t                old_size,
     size_t                new_size,
     size_t                align)
+{
+    unsigned char *new_ptr;
+
+    new_ptr = stack_resize_align_non_zeroed(s, old_ptr, old_size, new_size, align);
+    // Zero the growth region, whether we resized in-place or not.
+    if (new_ptr != NULL && old_size < new_size) {
+        memset(new_ptr + old_size, 0, new_size - old_size);
+    }
+    return new_ptr;
+}
+
+void *
+stack_resize_align_non_zeroed(Stack *s,
+    void                 *old_ptr,
+    size_t                old_size,
+    size_t                new_size,
+    size_t                align)
 {
     if (old_ptr == NULL) {
-        return stack_alloc_align(s, new_size, align);
+        return stack_alloc_align_non_zeroed(s, new_size, align);
     } else if (new_size == 0) {
         stack_free(s, old_ptr);
         return NULL;
     }
 
     uintptr_t start, end, curr_addr;
-    Stack_Allocation_Header *header;
-    size_t prev_offset;
     size_t min_size = (old_size < new_size) ? old_size : new_size;
     void *new_ptr;
 
@@ -140,31 +165,73 @@ stack_resize_align(Stack *s,
         return old_ptr;
     }
 
-    header = cast(Stack_Allocation_Header *)(curr_addr - sizeof(*header));
+    if (stack_try_resize_in_place(s, old_ptr, old_size, new_size)) {
+        return old_ptr;
+    }
+
+    new_ptr = stack_alloc_align_non_zeroed(s, new_size, align);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    return memmove(new_ptr, old_ptr, min_size);
+}
+
+/** @brief Walk the chain down from the top to find where the block right
+ *  after the one whose header is at `header_offset` begins.
+ *
+ * @return 0 if there is no such block in the chain.
+ */
+static size_t
+internal_stack_next_block_offset(const Stack *s, size_t header_offset)
+{
+    size_t iter = s->prev_offset;
+    size_t next = s->curr_offset;
 
-    // Calculate previous offset from header and its address.
-    prev_offset = cast(size_t)(curr_addr - cast(uintptr_t)header->padding - start);
+    while (iter != header_offset) {
+        const Stack_Allocation_Header *header;
 
-    // Can resize in-place?
-    if (prev_offset == s->prev_offset) {
-        // Resized allocation would be out of bounds in the stack?
-        if (prev_offset + header->padding + new_size > s->buf_len) {
-            return NULL;
+        header = cast(const Stack_Allocation_Header *)(s->buf + iter);
+        // Ran off the bottom of the chain?
+        if (header->prev_offset >= iter) {
+            return 0;
         }
+        next = iter + sizeof(*header) - header->padding;
+        iter = header->prev_offset;
+    }
+    return next;
+}
 
-        // Growing the allocation?
-        if (old_size < new_size) {
-            size_t growth = new_size - old_size;
-            memset(cast(void *)(curr_addr + old_size), 0, growth);
-            s->curr_offset += growth;
-        } else {
-            s->curr_offset -= old_size - new_size;
+bool
+stack_try_resize_in_place(Stack *s, void *old_ptr, size_t old_size, size_t new_size)
+{
+    Stack_Allocation_Header *header;
+    size_t header_offset, user_offset;
+    unsigned char *addr = cast(unsigned char *)old_ptr;
+
+    // Not a live block of ours?
+    if (!(s->buf <= addr && addr < s->buf + s->curr_offset)) {
+        return false;
+    }
+
+    header        = cast(Stack_Allocation_Header *)old_ptr - 1;
+    header_offset = cast(size_t)(cast(unsigned char *)header - s->buf);
+    user_offset   = header_offset + sizeof(*header);
+
+    // The top block may use the rest of the buffer.
+    if (header_offset == s->prev_offset) {
+        if (new_size > s->buf_len - user_offset) {
+            return false;
         }
-        return old_ptr;
+        s->curr_offset = user_offset + new_size;
+        return true;
     }
 
-    new_ptr = stack_alloc_align(s, new_size, align);
-    return memmove(new_ptr, old_ptr, min_size);
+    // Other blocks can always shrink, leaving the rest unused until the block
+    // grows again or everything above it is freed.
+    if (new_size <= old_size) {
+        return true;
+    }
+    return user_offset + new_size <= internal_stack_next_block_offset(s, header_offset);
 }
 
 void
@@ -176,7 +243,7 @@ stack_free(Stack *s, void *ptr)
 
     uintptr_t start, end, curr_addr;
     Stack_Allocation_Header *header;
-    size_t prev_offset;
+    size_t header_offset;
 
     start     = cast(uintptr_t)s->buf;
     end       = start + cast(uintptr_t)s->buf_len;
@@ -192,17 +259,15 @@ stack_free(Stack *s, void *ptr)
         return;
     }
 
-    header = cast(Stack_Allocation_Header *)(curr_addr - sizeof(*header));
-
-    // Calculate previous offset from header and its address.
-    prev_offset = cast(size_t)(curr_addr - cast(uintptr_t)header->padding - start);
-    if (prev_offset != s->prev_offset) {
+    header        = cast(Stack_Allocation_Header *)(curr_addr - sizeof(*header));
+    header_offset = cast(size_t)(cast(uintptr_t)header - start);
+    if (header_offset != s->prev_offset) {
         assert(0 && "Out of order stack allocator free");
         return;
     }
 
     // Reset the offsets to that of the previous allocation.
-    s->curr_offset = s->prev_offset;
+    s->curr_offset = cast(size_t)(curr_addr - cast(uintptr_t)header->padding - start);
     s->prev_offset = header->prev_offset;
 }
 
@@ -219,9 +284,11 @@ stack_allocator_fn(void *context,
     void                *old_ptr,
     size_t               old_size,
     size_t               new_size,
-    size_t               align)
+    size_t               align,
+    const char          *location)
 {
     Stack *s = cast(Stack *)context;
+    unused(location);
     switch (mode) {
     case ALLOCATOR_ALLOC:
         return stack_alloc_align(s, new_size, align);
@@ -233,6 +300,15 @@ stack_allocator_fn(void *context,
     case ALLOCATOR_FREE_ALL:
         stack_free_all(s);
         break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return stack_alloc_align_non_zeroed(s, new_size, align);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return stack_resize_align_non_zeroed(s, old_ptr, old_size, new_size, align);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (old_ptr != NULL && stack_try_resize_in_place(s, old_ptr, old_size, new_size)) {
+            return old_ptr;
+        }
+        break;
     }
     return NULL;
 }
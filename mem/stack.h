@@ -11,7 +11,7 @@ struct Stack {
     // The total number of indexable bytes in `buf`.
     size_t buf_len;
 
-    // The index of the previous header of the most recently allocated block.
+    // The index of the header of the most recently allocated block.
     size_t prev_offset;
 
     // The index of the first available byte in `buf`.
@@ -20,7 +20,8 @@ struct Stack {
 
 typedef struct Stack_Allocation_Header Stack_Allocation_Header;
 struct Stack_Allocation_Header {
-    // Index of the previous allocation.
+    // Index of the header of the previous allocation. Together with
+    // `Stack::prev_offset` this chains all live blocks from the top down.
     size_t prev_offset;
 
     // `maximum_alignment_in_bytes = 2**(8 * sizeof(padding) - 1)`
@@ -52,6 +53,29 @@ stack_resize_align(Stack *s,
     size_t                new_size,
     size_t                align);
 
+
+/** @brief Like `stack_alloc_align`, but the memory is not zeroed. */
+void *
+stack_alloc_align_non_zeroed(Stack *s, size_t size, size_t align);
+
+
+/** @brief Like `stack_resize_align`, but the growth region is not zeroed. */
+void *
+stack_resize_align_non_zeroed(Stack *s,
+    void                          *old_ptr,
+    size_t                         old_size,
+    size_t                         new_size,
+    size_t                         align);
+
+/** @brief Resize `old_ptr` without moving it. The top block can use the rest
+ *  of the buffer. Any other block can always shrink, and can grow back into
+ *  whatever space it left behind, up to where the next block begins.
+ *
+ * @return `false` if `old_ptr` would have to move, leaving it untouched.
+ */
+bool
+stack_try_resize_in_place(Stack *s, void *old_ptr, size_t old_size, size_t new_size);
+
 Allocator
 stack_allocator(Stack *s);
 
@@ -0,0 +1,321 @@
+#include <string.h> // memset, memcpy
+
+#include "thread_cache.h"
+
+typedef struct {
+    u64           global_id;
+    Thread_Cache *cache;
+} Thread_Cache_Slot;
+
+// Each thread only ever sees its own caches here, indexed and tagged by
+// `Thread_Cache_Global.id`. A cache is only followed once its tag matches, so
+// slots left over from a destroyed global are never dereferenced.
+static _Thread_local Thread_Cache_Slot
+thread_cache_slots[MEM_THREAD_CACHE_SLOTS];
+
+// Starts at 1, so that no global matches a slot that was never filled.
+static atomic_uint_least64_t
+thread_cache_next_id = 1;
+
+static void
+internal_thread_cache_lock(Thread_Cache_Global *g)
+{
+    while (atomic_flag_test_and_set_explicit(&g->lock, memory_order_acquire)) {
+        // Spin. Critical sections are a single backing allocator call.
+    }
+}
+
+static void
+internal_thread_cache_unlock(Thread_Cache_Global *g)
+{
+    atomic_flag_clear_explicit(&g->lock, memory_order_release);
+}
+
+static void *
+thread_cache_global_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Thread_Cache_Global *g = cast(Thread_Cache_Global *)context;
+    void *ptr;
+
+    internal_thread_cache_lock(g);
+    ptr = g->backing.fn(g->backing.context, mode, old_ptr, old_size, new_size,
+        align, location);
+    internal_thread_cache_unlock(g);
+    return ptr;
+}
+
+void
+thread_cache_global_init(Thread_Cache_Global *g,
+    Allocator backing,
+    size_t    small_max,
+    size_t    block_size)
+{
+    g->backing    = backing;
+    g->small_max  = (small_max == 0) ? MEM_THREAD_CACHE_DEFAULT_SMALL_MAX : small_max;
+    g->block_size = (block_size == 0) ? MEM_GROWING_ARENA_DEFAULT_BLOCK_SIZE : block_size;
+    g->caches     = NULL;
+    g->id         = atomic_fetch_add_explicit(&thread_cache_next_id, 1,
+        memory_order_relaxed);
+    atomic_flag_clear(&g->lock);
+}
+
+void
+thread_cache_global_destroy(Thread_Cache_Global *g)
+{
+    Thread_Cache_Slot *slot  = &thread_cache_slots[g->id % MEM_THREAD_CACHE_SLOTS];
+    Thread_Cache      *cache = g->caches;
+
+    // Other threads' slots still name `g`, but its id is never handed out
+    // again, so they can never match.
+    if (slot->global_id == g->id) {
+        slot->global_id = 0;
+        slot->cache     = NULL;
+    }
+    while (cache != NULL) {
+        Thread_Cache *next = cache->next;
+        growing_arena_destroy(&cache->arena);
+        mem_free(cache, sizeof(*cache), g->backing);
+        cache = next;
+    }
+    g->caches = NULL;
+}
+
+void
+thread_cache_global_reset(Thread_Cache_Global *g)
+{
+    for (Thread_Cache *cache = g->caches; cache != NULL; cache = cache->next) {
+        growing_arena_free_all(&cache->arena);
+    }
+}
+
+Allocator
+thread_cache_global_allocator(Thread_Cache_Global *g)
+{
+    Allocator a = {thread_cache_global_allocator_fn, g};
+    return a;
+}
+
+/** @brief The calling thread's cache for `g`, or `NULL` if it has none yet. */
+static Thread_Cache *
+internal_thread_cache_find(Thread_Cache_Global *g)
+{
+    Thread_Cache_Slot *slot = &thread_cache_slots[g->id % MEM_THREAD_CACHE_SLOTS];
+    Thread_Cache      *cache;
+
+    if (slot->global_id == g->id) {
+        return slot->cache;
+    }
+
+    // Never used `g`, or its slot was taken by another global since. The
+    // address of our slots identifies this thread among the running ones.
+    // A new thread may inherit that address, and with it the cache, of one
+    // that exited, which can no longer use it anyway.
+    internal_thread_cache_lock(g);
+    for (cache = g->caches; cache != NULL; cache = cache->next) {
+        if (cache->owner == thread_cache_slots) {
+            break;
+        }
+    }
+    internal_thread_cache_unlock(g);
+
+    if (cache != NULL) {
+        slot->global_id = g->id;
+        slot->cache     = cache;
+    }
+    return cache;
+}
+
+static Thread_Cache *
+internal_thread_cache_get(Thread_Cache_Global *g)
+{
+    Thread_Cache_Slot *slot;
+    Thread_Cache      *cache = internal_thread_cache_find(g);
+    if (cache != NULL) {
+        return cache;
+    }
+
+    // First request from this thread. The cache lives in the backing
+    // allocator rather than thread-local storage so that it can still be
+    // reset and destroyed after the thread exits.
+    internal_thread_cache_lock(g);
+    cache = cast(Thread_Cache *)mem_alloc_align(sizeof(*cache), alignof(Thread_Cache),
+        g->backing);
+    if (cache != NULL) {
+        cache->global = g;
+        cache->owner  = thread_cache_slots;
+        cache->next   = g->caches;
+        g->caches     = cache;
+    }
+    internal_thread_cache_unlock(g);
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    growing_arena_init(&cache->arena, g->block_size, thread_cache_global_allocator(g));
+    slot            = &thread_cache_slots[g->id % MEM_THREAD_CACHE_SLOTS];
+    slot->global_id = g->id;
+    slot->cache     = cache;
+    return cache;
+}
+
+static bool
+internal_thread_cache_is_small(Thread_Cache *cache, size_t size)
+{
+    return size <= cache->global->small_max;
+}
+
+static void *
+internal_thread_cache_alloc(Thread_Cache *cache,
+    size_t      size,
+    size_t      align,
+    bool        zero,
+    const char *location)
+{
+    Allocator global = thread_cache_global_allocator(cache->global);
+
+    if (internal_thread_cache_is_small(cache, size)) {
+        return zero
+            ? growing_arena_alloc_align(&cache->arena, size, align)
+            : growing_arena_alloc_align_non_zeroed(&cache->arena, size, align);
+    }
+    return zero
+        ? mem_alloc_align_loc(size, align, global, location)
+        : mem_alloc_align_non_zeroed_loc(size, align, global, location);
+}
+
+static void
+internal_thread_cache_free(Thread_Cache *cache,
+    void       *ptr,
+    size_t      size,
+    const char *location)
+{
+    // Small blocks are reclaimed in bulk by the next reset.
+    if (!internal_thread_cache_is_small(cache, size)) {
+        mem_free_loc(ptr, size, thread_cache_global_allocator(cache->global), location);
+    }
+}
+
+static void *
+internal_thread_cache_resize(Thread_Cache *cache,
+    void       *old_ptr,
+    size_t      old_size,
+    size_t      new_size,
+    size_t      align,
+    bool        zero,
+    const char *location)
+{
+    Allocator global = thread_cache_global_allocator(cache->global);
+    bool old_small, new_small;
+    unsigned char *new_ptr;
+
+    if (old_ptr == NULL) {
+        return internal_thread_cache_alloc(cache, new_size, align, zero, location);
+    } else if (new_size == 0) {
+        internal_thread_cache_free(cache, old_ptr, old_size, location);
+        return NULL;
+    }
+
+    old_small = internal_thread_cache_is_small(cache, old_size);
+    new_small = internal_thread_cache_is_small(cache, new_size);
+    if (old_small && new_small) {
+        return zero
+            ? growing_arena_resize_align(&cache->arena, old_ptr, old_size, new_size, align)
+            : growing_arena_resize_align_non_zeroed(&cache->arena, old_ptr, old_size,
+                new_size, align);
+    } else if (!old_small && !new_small) {
+        return zero
+            ? mem_resize_align_loc(old_ptr, old_size, new_size, align, global,
+                location)
+            : mem_resize_align_non_zeroed_loc(old_ptr, old_size, new_size, align,
+                global, location);
+    }
+
+    // Crossing `small_max` in either direction; the block changes owners.
+    new_ptr = cast(unsigned char *)internal_thread_cache_alloc(cache, new_size, align,
+        /*zero=*/false, location);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, old_ptr, (old_size < new_size) ? old_size : new_size);
+    if (zero && old_size < new_size) {
+        memset(new_ptr + old_size, 0, new_size - old_size);
+    }
+    internal_thread_cache_free(cache, old_ptr, old_size, location);
+    return new_ptr;
+}
+
+static void *
+thread_cache_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Thread_Cache *cache = cast(Thread_Cache *)context;
+    switch (mode) {
+    case ALLOCATOR_ALLOC:
+        return internal_thread_cache_alloc(cache, new_size, align, /*zero=*/true,
+            location);
+    case ALLOCATOR_RESIZE:
+        return internal_thread_cache_resize(cache, old_ptr, old_size, new_size,
+            align, /*zero=*/true, location);
+    case ALLOCATOR_FREE:
+        internal_thread_cache_free(cache, old_ptr, old_size, location);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        // Large allocations are not tracked; their owners must free them.
+        growing_arena_free_all(&cache->arena);
+        break;
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        return internal_thread_cache_alloc(cache, new_size, align, /*zero=*/false,
+            location);
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        return internal_thread_cache_resize(cache, old_ptr, old_size, new_size,
+            align, /*zero=*/false, location);
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE: {
+        bool old_small = internal_thread_cache_is_small(cache, old_size);
+        bool new_small = internal_thread_cache_is_small(cache, new_size);
+        bool resized   = false;
+
+        // Crossing `small_max` always means changing owners.
+        if (old_small && new_small) {
+            resized = growing_arena_try_resize_in_place(&cache->arena, old_ptr,
+                old_size, new_size);
+        } else if (!old_small && !new_small) {
+            resized = mem_try_resize_in_place_loc(old_ptr, old_size, new_size,
+                thread_cache_global_allocator(cache->global), location);
+        }
+        return resized ? old_ptr : NULL;
+    }
+    }
+    return NULL;
+}
+
+Allocator
+thread_cache_allocator(Thread_Cache_Global *g)
+{
+    Allocator a = {thread_cache_allocator_fn, internal_thread_cache_get(g)};
+    // Could not even allocate the cache itself; route everything to
+    // the shared allocator instead.
+    if (a.context == NULL) {
+        return thread_cache_global_allocator(g);
+    }
+    return a;
+}
+
+void
+thread_cache_reset(Thread_Cache_Global *g)
+{
+    Thread_Cache *cache = internal_thread_cache_find(g);
+    if (cache != NULL) {
+        growing_arena_free_all(&cache->arena);
+    }
+}
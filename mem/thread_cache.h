@@ -0,0 +1,104 @@
+#ifndef MEM_THREAD_CACHE_H
+#define MEM_THREAD_CACHE_H
+
+#include <stdatomic.h> // atomic_flag
+
+#include "growing_arena.h"
+
+// Requests bigger than this many bytes bypass the per-thread arenas.
+#ifndef MEM_THREAD_CACHE_DEFAULT_SMALL_MAX
+#define MEM_THREAD_CACHE_DEFAULT_SMALL_MAX  (4 * 1024)
+#endif // MEM_THREAD_CACHE_DEFAULT_SMALL_MAX
+
+// Caches each thread can look up without taking the lock, one per global
+// allocator it uses at once. Globals whose ids collide evict each other, and
+// then fall back to a locked search.
+#ifndef MEM_THREAD_CACHE_SLOTS
+#define MEM_THREAD_CACHE_SLOTS  4
+#endif // MEM_THREAD_CACHE_SLOTS
+
+typedef struct Thread_Cache_Global Thread_Cache_Global;
+
+// Owned by exactly one thread, so allocating from it needs no locking.
+typedef struct Thread_Cache Thread_Cache;
+struct Thread_Cache {
+    Thread_Cache_Global *global;
+
+    // Next cache registered with `global`.
+    Thread_Cache *next;
+
+    // Identifies the thread that created this cache.
+    const void *owner;
+
+    // Serves all small requests. Its blocks come from `global`.
+    Growing_Arena arena;
+};
+
+// State shared by all threads. Only touched when a thread needs a new
+// arena block, makes a large request, or registers its cache.
+struct Thread_Cache_Global {
+    Allocator backing;
+
+    // Unique among every global ever initialized, even at the same address,
+    // so that threads can tell a destroyed global from its successor.
+    u64 id;
+
+    // Spinlock guarding `backing` and `caches`.
+    atomic_flag lock;
+
+    // Largest request served by the per-thread arenas.
+    size_t small_max;
+
+    // Block size of each per-thread arena.
+    size_t block_size;
+
+    // Every cache created so far, so that they can be reset in bulk.
+    Thread_Cache *caches;
+};
+
+
+/** @brief `backing` need not be thread-safe; all access to it is serialized.
+ *  Zero `small_max` or `block_size` to use their defaults. */
+void
+thread_cache_global_init(Thread_Cache_Global *g,
+    Allocator backing,
+    size_t    small_max,
+    size_t    block_size);
+
+
+/** @brief Return every per-thread cache to the backing allocator. Any
+ *  outstanding large allocations must be freed beforehand. */
+void
+thread_cache_global_destroy(Thread_Cache_Global *g);
+
+
+/** @brief Reset the arenas of all threads at once, e.g. at the end of a
+ *  Game of Life generation. No other thread may allocate from `g` meanwhile;
+ *  call it after the workers have joined or reached a barrier. */
+void
+thread_cache_global_reset(Thread_Cache_Global *g);
+
+
+/** @brief The shared backing allocator, serialized by the spinlock. */
+Allocator
+thread_cache_global_allocator(Thread_Cache_Global *g);
+
+
+/** @brief The calling thread's allocator, creating its cache on first use.
+ *
+ * @note
+ *  Small requests are bump-allocated from the thread's own arena, so freeing
+ *  them does nothing until the next reset. Large requests go straight to the
+ *  backing allocator and must be freed individually.
+ *
+ *  The returned `Allocator` must only be used by the calling thread.
+ */
+Allocator
+thread_cache_allocator(Thread_Cache_Global *g);
+
+
+/** @brief Reset only the calling thread's arena. */
+void
+thread_cache_reset(Thread_Cache_Global *g);
+
+#endif /* MEM_THREAD_CACHE_H */
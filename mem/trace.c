@@ -0,0 +1,583 @@
+#include <string.h> // memcmp
+
+#include "trace.h"
+
+// File header: the magic bytes, then a single version byte.
+#define TRACE_MAGIC     "MEMTRACE"
+#define TRACE_VERSION   1
+
+// Each record starts with a byte holding the `Allocator_Mode` in its low
+// bits and log2 of the alignment above them.
+#define TRACE_MODE_BITS 3
+#define TRACE_MODE_MASK ((1 << TRACE_MODE_BITS) - 1)
+
+void
+trace_init(Trace *t, Allocator allocator)
+{
+    t->ops       = NULL;
+    t->count     = 0;
+    t->cap       = 0;
+    t->id_count  = 0;
+    t->allocator = allocator;
+}
+
+void
+trace_destroy(Trace *t)
+{
+    array_delete(t->ops, t->cap, t->allocator);
+    trace_init(t, t->allocator);
+}
+
+bool
+trace_push(Trace *t, Trace_Op op)
+{
+    if (t->count == t->cap) {
+        size_t new_cap = (t->cap == 0) ? 1024 : t->cap * 2;
+        Trace_Op *new_ops;
+
+        new_ops = array_resize_non_zeroed(Trace_Op, t->ops, t->cap, new_cap, t->allocator);
+        if (new_ops == NULL) {
+            return false;
+        }
+        t->ops = new_ops;
+        t->cap = new_cap;
+    }
+    t->ops[t->count++] = op;
+    if (op.mode != ALLOCATOR_FREE_ALL && op.id >= t->id_count) {
+        t->id_count = op.id + 1;
+    }
+    return true;
+}
+
+bool
+trace_is_lifo(const Trace *t)
+{
+    size_t *stack, top = 0;
+    bool lifo = true;
+
+    // Ids of the live blocks, most recent last.
+    stack = array_make_non_zeroed(size_t, t->id_count, t->allocator);
+    if (stack == NULL && t->id_count > 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < t->count && lifo; i += 1) {
+        Trace_Op op = t->ops[i];
+        switch (op.mode) {
+        case ALLOCATOR_ALLOC:
+        case ALLOCATOR_ALLOC_NON_ZEROED:
+            stack[top++] = op.id;
+            break;
+        case ALLOCATOR_RESIZE:
+        case ALLOCATOR_RESIZE_NON_ZEROED:
+        case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+            lifo = top > 0 && stack[top - 1] == op.id;
+            if (lifo && op.size == 0 && op.mode != ALLOCATOR_TRY_RESIZE_IN_PLACE) {
+                top -= 1;
+            }
+            break;
+        case ALLOCATOR_FREE:
+            lifo = top > 0 && stack[top - 1] == op.id;
+            top -= lifo;
+            break;
+        case ALLOCATOR_FREE_ALL:
+            top = 0;
+            break;
+        }
+    }
+    array_delete(stack, t->id_count, t->allocator);
+    return lifo;
+}
+
+static void
+internal_trace_write_varint(FILE *stream, size_t value)
+{
+    // LEB128: 7 bits at a time, least significant first.
+    while (value >= 0x80) {
+        fputc(cast(int)((value & 0x7f) | 0x80), stream);
+        value >>= 7;
+    }
+    fputc(cast(int)value, stream);
+}
+
+static bool
+internal_trace_read_varint(FILE *stream, size_t *value)
+{
+    size_t result = 0;
+
+    for (unsigned int shift = 0; shift < sizeof(size_t) * CHAR_BIT; shift += 7) {
+        int c = fgetc(stream);
+        if (c == EOF) {
+            return false;
+        }
+        result |= cast(size_t)(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static unsigned int
+internal_trace_log2(size_t align)
+{
+    unsigned int n = 0;
+    while (align > 1) {
+        align >>= 1;
+        n += 1;
+    }
+    return n;
+}
+
+Trace_Error
+trace_read(Trace *t, FILE *stream)
+{
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    size_t base = t->id_count, next_id = 0;
+    int c;
+
+    if (fread(magic, 1, sizeof(magic), stream) != sizeof(magic)) {
+        return ferror(stream) ? TRACE_ERROR_IO : TRACE_ERROR_FORMAT;
+    } else if (memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0
+        || fgetc(stream) != TRACE_VERSION)
+    {
+        return TRACE_ERROR_FORMAT;
+    }
+
+    // Ids start over in each file, so offset them past the ones we have.
+    while ((c = fgetc(stream)) != EOF) {
+        Trace_Op op;
+        bool ok = true;
+
+        op.mode  = cast(Allocator_Mode)(c & TRACE_MODE_MASK);
+        op.id    = 0;
+        op.size  = 0;
+        op.align = cast(size_t)1 << (c >> TRACE_MODE_BITS);
+        switch (op.mode) {
+        case ALLOCATOR_ALLOC:
+        case ALLOCATOR_ALLOC_NON_ZEROED:
+            op.id = base + next_id++;
+            ok    = internal_trace_read_varint(stream, &op.size);
+            break;
+        case ALLOCATOR_RESIZE:
+        case ALLOCATOR_RESIZE_NON_ZEROED:
+        case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+            ok = internal_trace_read_varint(stream, &op.id)
+                && internal_trace_read_varint(stream, &op.size);
+            op.id += base;
+            break;
+        case ALLOCATOR_FREE:
+            ok     = internal_trace_read_varint(stream, &op.id);
+            op.id += base;
+            break;
+        case ALLOCATOR_FREE_ALL:
+            break;
+        default:
+            ok = false;
+            break;
+        }
+
+        if (!ok || (op.mode != ALLOCATOR_FREE_ALL && op.id >= base + next_id)) {
+            return ferror(stream) ? TRACE_ERROR_IO : TRACE_ERROR_FORMAT;
+        } else if (!trace_push(t, op)) {
+            return TRACE_ERROR_MEMORY;
+        }
+    }
+    return ferror(stream) ? TRACE_ERROR_IO : TRACE_OK;
+}
+
+bool
+trace_recorder_init(Trace_Recorder *r, Allocator backing, FILE *stream, Allocator meta)
+{
+    r->backing       = backing;
+    r->stream        = stream;
+    r->entries       = NULL;
+    r->entry_count   = 0;
+    r->entry_cap     = 0;
+    r->meta          = meta;
+    r->next_id       = 0;
+    r->op_count      = 0;
+    r->unknown_count = 0;
+
+    fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC) - 1, stream);
+    fputc(TRACE_VERSION, stream);
+    return !ferror(stream);
+}
+
+void
+trace_recorder_destroy(Trace_Recorder *r)
+{
+    array_delete(r->entries, r->entry_cap, r->meta);
+    r->entries     = NULL;
+    r->entry_count = 0;
+    r->entry_cap   = 0;
+}
+
+static size_t
+internal_trace_hash(uintptr_t ptr, size_t cap)
+{
+    // The low bits are mostly zero due to alignment.
+    u64 h = cast(u64)(ptr >> 4) * 0x9E3779B97F4A7C15u;
+    return cast(size_t)(h ^ (h >> 32)) & (cap - 1);
+}
+
+static Trace_Entry *
+internal_trace_recorder_find(Trace_Recorder *r, void *ptr)
+{
+    size_t mask = r->entry_cap - 1;
+
+    if (ptr == NULL || r->entry_cap == 0) {
+        return NULL;
+    }
+    for (size_t i = internal_trace_hash(cast(uintptr_t)ptr, r->entry_cap);;
+        i = (i + 1) & mask)
+    {
+        Trace_Entry *entry = &r->entries[i];
+        if (entry->ptr == 0) {
+            return NULL;
+        } else if (entry->ptr == cast(uintptr_t)ptr) {
+            return entry;
+        }
+    }
+}
+
+static void
+internal_trace_recorder_put(Trace_Entry *entries, size_t cap, uintptr_t ptr, size_t id)
+{
+    size_t i = internal_trace_hash(ptr, cap);
+    while (entries[i].ptr != 0) {
+        i = (i + 1) & (cap - 1);
+    }
+    entries[i].ptr = ptr;
+    entries[i].id  = id;
+}
+
+static bool
+internal_trace_recorder_insert(Trace_Recorder *r, void *ptr, size_t id)
+{
+    // Keep the table at most half full.
+    if ((r->entry_count + 1) * 2 > r->entry_cap) {
+        size_t new_cap = (r->entry_cap == 0) ? 64 : r->entry_cap * 2;
+        Trace_Entry *new_entries;
+
+        new_entries = array_make(Trace_Entry, new_cap, r->meta);
+        if (new_entries == NULL) {
+            return false;
+        }
+        for (size_t i = 0; i < r->entry_cap; i += 1) {
+            if (r->entries[i].ptr != 0) {
+                internal_trace_recorder_put(new_entries, new_cap, r->entries[i].ptr,
+                    r->entries[i].id);
+            }
+        }
+        array_delete(r->entries, r->entry_cap, r->meta);
+        r->entries   = new_entries;
+        r->entry_cap = new_cap;
+    }
+    internal_trace_recorder_put(r->entries, r->entry_cap, cast(uintptr_t)ptr, id);
+    r->entry_count += 1;
+    return true;
+}
+
+static void
+internal_trace_recorder_remove(Trace_Recorder *r, Trace_Entry *entry)
+{
+    size_t mask = r->entry_cap - 1;
+    size_t hole = cast(size_t)(entry - r->entries);
+
+    // Shift later entries of the same probe sequence back into the hole, so
+    // that lookups never stop early at it.
+    for (size_t i = (hole + 1) & mask; r->entries[i].ptr != 0; i = (i + 1) & mask) {
+        size_t home = internal_trace_hash(r->entries[i].ptr, r->entry_cap);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            r->entries[hole] = r->entries[i];
+            hole = i;
+        }
+    }
+    r->entries[hole].ptr = 0;
+    r->entry_count      -= 1;
+}
+
+static void
+internal_trace_recorder_write(Trace_Recorder *r, Trace_Op op)
+{
+    unsigned int header;
+
+    header = cast(unsigned int)op.mode
+        | internal_trace_log2(op.align) << TRACE_MODE_BITS;
+    fputc(cast(int)header, r->stream);
+    switch (op.mode) {
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        // The id is implied by the order of allocations.
+        internal_trace_write_varint(r->stream, op.size);
+        break;
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        internal_trace_write_varint(r->stream, op.id);
+        internal_trace_write_varint(r->stream, op.size);
+        break;
+    case ALLOCATOR_FREE:
+        internal_trace_write_varint(r->stream, op.id);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        break;
+    }
+    r->op_count += 1;
+}
+
+void
+trace_recorder_free_all(Trace_Recorder *r)
+{
+    Trace_Op op = {ALLOCATOR_FREE_ALL, 0, 0, 1};
+
+    internal_trace_recorder_write(r, op);
+    if (r->entries != NULL) {
+        memset(r->entries, 0, sizeof(r->entries[0]) * r->entry_cap);
+    }
+    r->entry_count = 0;
+}
+
+static void *
+trace_recorder_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Trace_Recorder *r = cast(Trace_Recorder *)context;
+    Trace_Entry *entry;
+    Trace_Op op = {mode, 0, new_size, align};
+    void *new_ptr;
+
+    // `mem_try_resize_in_place` and `mem_free` pass no alignment. Record the
+    // default, so that a replay that has to move the block instead lays it
+    // out like the blocks around it rather than byte-aligned.
+    if (op.align == 0) {
+        op.align = MEM_DEFAULT_ALIGNMENT;
+    }
+
+    new_ptr = r->backing.fn(r->backing.context, mode, old_ptr, old_size, new_size,
+        align, location);
+    switch (mode) {
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        if (old_ptr != NULL) {
+            entry = internal_trace_recorder_find(r, old_ptr);
+            if (entry == NULL) {
+                r->unknown_count += 1;
+                break;
+            } else if (new_ptr == NULL && new_size != 0) {
+                // Failed; `old_ptr` is still intact.
+                break;
+            }
+
+            op.id = entry->id;
+            internal_trace_recorder_write(r, op);
+            if (new_ptr != old_ptr) {
+                internal_trace_recorder_remove(r, entry);
+                if (new_ptr != NULL) {
+                    internal_trace_recorder_insert(r, new_ptr, op.id);
+                }
+            }
+            break;
+        }
+
+        // Resizing `NULL` is just an allocation.
+        op.mode = (mode == ALLOCATOR_RESIZE) ? ALLOCATOR_ALLOC : ALLOCATOR_ALLOC_NON_ZEROED;
+        // fallthrough
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        if (new_ptr != NULL) {
+            op.id = r->next_id++;
+            internal_trace_recorder_write(r, op);
+            internal_trace_recorder_insert(r, new_ptr, op.id);
+        }
+        break;
+    case ALLOCATOR_FREE:
+        if (old_ptr == NULL) {
+            break;
+        }
+        entry = internal_trace_recorder_find(r, old_ptr);
+        if (entry == NULL) {
+            r->unknown_count += 1;
+            break;
+        }
+        op.id = entry->id;
+        internal_trace_recorder_write(r, op);
+        internal_trace_recorder_remove(r, entry);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        trace_recorder_free_all(r);
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        if (new_ptr == NULL) {
+            break;
+        }
+        entry = internal_trace_recorder_find(r, old_ptr);
+        if (entry == NULL) {
+            r->unknown_count += 1;
+            break;
+        }
+        op.id = entry->id;
+        internal_trace_recorder_write(r, op);
+        break;
+    }
+    return new_ptr;
+}
+
+Allocator
+trace_recorder_allocator(Trace_Recorder *r)
+{
+    Allocator a = {trace_recorder_allocator_fn, r};
+    return a;
+}
+
+bool
+trace_replay_init(Trace_Replay *r, const Trace *t, Allocator meta)
+{
+    r->ptrs           = array_make(unsigned char *, t->id_count, meta);
+    r->sizes          = array_make(size_t, t->id_count, meta);
+    r->id_count       = t->id_count;
+    r->meta           = meta;
+    r->failed         = 0;
+    r->peak_requested = 0;
+    r->peak_span      = 0;
+    r->live_lo        = t->id_count;
+    r->live_hi        = 0;
+    if ((r->ptrs == NULL || r->sizes == NULL) && t->id_count > 0) {
+        trace_replay_destroy(r);
+        return false;
+    }
+    return true;
+}
+
+void
+trace_replay_destroy(Trace_Replay *r)
+{
+    array_delete(r->ptrs, r->id_count, r->meta);
+    array_delete(r->sizes, r->id_count, r->meta);
+    r->ptrs     = NULL;
+    r->sizes    = NULL;
+    r->id_count = 0;
+}
+
+
+/** @brief Free every live block, most recent id first. */
+static void
+internal_trace_replay_release(Trace_Replay *r, Allocator allocator)
+{
+    for (size_t id = r->live_hi; id > r->live_lo; id -= 1) {
+        mem_free(r->ptrs[id - 1], r->sizes[id - 1], allocator);
+        r->ptrs[id - 1]  = NULL;
+        r->sizes[id - 1] = 0;
+    }
+    r->live_lo = r->id_count;
+    r->live_hi = 0;
+}
+
+void
+trace_replay_run(Trace_Replay *r, const Trace *t, Allocator allocator)
+{
+    uintptr_t lo = UINTPTR_MAX, hi = 0;
+    size_t live = 0;
+
+    assert(r->id_count >= t->id_count);
+    assert(r->live_lo >= r->live_hi && "trace_replay_release was not called");
+    r->failed         = 0;
+    r->peak_requested = 0;
+    r->peak_span      = 0;
+
+    // Whoever used the memory behind `allocator` last may have left it in
+    // any state.
+    mem_free_all(allocator);
+    for (size_t i = 0; i < t->count; i += 1) {
+        Trace_Op op = t->ops[i];
+        unsigned char *ptr = NULL;
+
+        switch (op.mode) {
+        case ALLOCATOR_ALLOC:
+            ptr = cast(unsigned char *)mem_alloc_align(op.size, op.align, allocator);
+            break;
+        case ALLOCATOR_ALLOC_NON_ZEROED:
+            ptr = cast(unsigned char *)mem_alloc_align_non_zeroed(op.size, op.align,
+                allocator);
+            break;
+        case ALLOCATOR_RESIZE:
+        case ALLOCATOR_RESIZE_NON_ZEROED:
+            if (op.mode == ALLOCATOR_RESIZE) {
+                ptr = cast(unsigned char *)mem_resize_align(r->ptrs[op.id],
+                    r->sizes[op.id], op.size, op.align, allocator);
+            } else {
+                ptr = cast(unsigned char *)mem_resize_align_non_zeroed(r->ptrs[op.id],
+                    r->sizes[op.id], op.size, op.align, allocator);
+            }
+            if (op.size == 0) {
+                live            -= r->sizes[op.id];
+                r->ptrs[op.id]   = NULL;
+                r->sizes[op.id]  = 0;
+                continue;
+            }
+            break;
+        case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+            if (mem_try_resize_in_place(r->ptrs[op.id], r->sizes[op.id], op.size,
+                allocator))
+            {
+                ptr = r->ptrs[op.id];
+                break;
+            }
+            // The recorded caller got it in place, so it never had to move
+            // the block. Callers of ours would, so do that instead.
+            ptr = cast(unsigned char *)mem_resize_align_non_zeroed(r->ptrs[op.id],
+                r->sizes[op.id], op.size, op.align, allocator);
+            break;
+        case ALLOCATOR_FREE:
+            mem_free(r->ptrs[op.id], r->sizes[op.id], allocator);
+            live            -= r->sizes[op.id];
+            r->ptrs[op.id]   = NULL;
+            r->sizes[op.id]  = 0;
+            continue;
+        case ALLOCATOR_FREE_ALL:
+            internal_trace_replay_release(r, allocator);
+            mem_free_all(allocator);
+            live = 0;
+            lo   = UINTPTR_MAX;
+            hi   = 0;
+            continue;
+        }
+
+        // Failed resizes leave the old block intact.
+        if (ptr == NULL) {
+            r->failed += 1;
+            continue;
+        }
+        if (op.size > 0) {
+            ptr[0] = ptr[op.size - 1] = cast(unsigned char)i;
+        }
+        live           += op.size - r->sizes[op.id];
+        r->ptrs[op.id]  = ptr;
+        r->sizes[op.id] = op.size;
+        r->live_lo      = (op.id < r->live_lo) ? op.id : r->live_lo;
+        r->live_hi      = (op.id + 1 > r->live_hi) ? op.id + 1 : r->live_hi;
+
+        lo = (cast(uintptr_t)ptr < lo) ? cast(uintptr_t)ptr : lo;
+        hi = (cast(uintptr_t)ptr + op.size > hi) ? cast(uintptr_t)ptr + op.size : hi;
+        if (live > r->peak_requested) {
+            r->peak_requested = live;
+        }
+        if (hi - lo > r->peak_span) {
+            r->peak_span = cast(size_t)(hi - lo);
+        }
+    }
+}
+
+void
+trace_replay_release(Trace_Replay *r, Allocator allocator)
+{
+    internal_trace_replay_release(r, allocator);
+    mem_free_all(allocator);
+}
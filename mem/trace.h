@@ -0,0 +1,173 @@
+#ifndef MEM_TRACE_H
+#define MEM_TRACE_H
+
+#include <stdio.h> // FILE
+
+#include "allocator.h"
+
+/**
+ * @brief One request in an allocation trace.
+ *
+ * @note
+ *  Blocks are named by `id` rather than by address so that a trace can be
+ *  replayed against any allocator. Resizing a block keeps its id even if it
+ *  moves. `Trace_Recorder` hands out ids in allocation order and never
+ *  reuses them; hand-written traces may reuse the id of a freed block.
+ */
+typedef struct Trace_Op Trace_Op;
+struct Trace_Op {
+    Allocator_Mode mode;
+
+    // Unused by `ALLOCATOR_FREE_ALL`.
+    size_t id;
+
+    // Unused by `ALLOCATOR_FREE` and `ALLOCATOR_FREE_ALL`.
+    size_t size;
+    size_t align;
+};
+
+typedef struct Trace Trace;
+struct Trace {
+    Trace_Op *ops;
+    size_t count;
+    size_t cap;
+
+    // Every `id` in `ops` is less than this.
+    size_t id_count;
+
+    // Owns `ops`.
+    Allocator allocator;
+};
+
+typedef enum {
+    TRACE_OK,
+    TRACE_ERROR_IO,
+    TRACE_ERROR_FORMAT,
+    TRACE_ERROR_MEMORY,
+} Trace_Error;
+
+// Lives in the table mapping live addresses to ids.
+typedef struct Trace_Entry Trace_Entry;
+struct Trace_Entry {
+    // 0 if this slot is unused.
+    uintptr_t ptr;
+    size_t    id;
+};
+
+typedef struct Trace_Recorder Trace_Recorder;
+struct Trace_Recorder {
+    Allocator backing;
+    FILE     *stream;
+
+    // Open-addressed table keyed by `ptr`, allocated from `meta`.
+    Trace_Entry *entries;
+    size_t       entry_count;
+    size_t       entry_cap;
+    Allocator    meta;
+
+    size_t next_id;
+    size_t op_count;
+
+    // Frees and resizes of blocks allocated before recording started, or
+    // that did not fit into `entries`. These cannot be replayed.
+    size_t unknown_count;
+};
+
+typedef struct Trace_Replay Trace_Replay;
+struct Trace_Replay {
+    // Indexed by `Trace_Op.id`, allocated from `meta`.
+    unsigned char **ptrs;
+    size_t         *sizes;
+    size_t          id_count;
+    Allocator       meta;
+
+    // Only ids in `[live_lo, live_hi)` were handed out since the last
+    // `ALLOCATOR_FREE_ALL`, so only those can still be live. Recorded traces
+    // never reuse ids, so this stays as narrow as one REPL line.
+    size_t live_lo, live_hi;
+
+    // Results of the last `trace_replay_run`.
+    size_t failed;
+
+    // Most bytes live at once, according to the sizes in the trace.
+    size_t peak_requested;
+
+    // Widest range of addresses handed out between `ALLOCATOR_FREE_ALL`s.
+    // This is the high-water mark of allocators that carve up a single
+    // buffer, but means little for the others.
+    size_t peak_span;
+};
+
+void
+trace_init(Trace *t, Allocator allocator);
+
+void
+trace_destroy(Trace *t);
+
+
+/** @brief Append `op`, bumping `id_count` as needed. */
+bool
+trace_push(Trace *t, Trace_Op op);
+
+
+/** @brief Whether every free and resize targets the most recently allocated
+ *  live block, so that e.g. a `Stack` can replay `t`. */
+bool
+trace_is_lifo(const Trace *t);
+
+
+/** @brief Append every request recorded by a `Trace_Recorder` in `stream`. */
+Trace_Error
+trace_read(Trace *t, FILE *stream);
+
+
+/** @brief Write the file header to `stream`, and record every request made
+ *  through `trace_recorder_allocator(r)` to it from now on.
+ *
+ * @param meta  Holds the table of live blocks. Must not be `r` itself.
+ */
+bool
+trace_recorder_init(Trace_Recorder *r, Allocator backing, FILE *stream, Allocator meta);
+
+
+/** @brief Free the table of live blocks. Does not close `stream`. */
+void
+trace_recorder_destroy(Trace_Recorder *r);
+
+
+/** @brief Record an `ALLOCATOR_FREE_ALL` without forwarding it, for owners
+ *  that release memory behind the allocator's back, e.g. with
+ *  `temp_growing_arena_memory_end`. */
+void
+trace_recorder_free_all(Trace_Recorder *r);
+
+
+/** @brief Forward all requests to `backing`, writing the successful ones to
+ *  `stream`. Not thread-safe. */
+Allocator
+trace_recorder_allocator(Trace_Recorder *r);
+
+bool
+trace_replay_init(Trace_Replay *r, const Trace *t, Allocator meta);
+
+void
+trace_replay_destroy(Trace_Replay *r);
+
+
+/** @brief Re-issue every request in `t` to `allocator`, writing the first
+ *  and last byte of every block handed out. Blocks still live at the end are
+ *  left for `trace_replay_release`, which must be called before the next run.
+ *
+ *  Frees are issued individually even for `ALLOCATOR_FREE_ALL`, as not all
+ *  allocators support it.
+ */
+void
+trace_replay_run(Trace_Replay *r, const Trace *t, Allocator allocator);
+
+
+/** @brief Free whatever the last `trace_replay_run` left live, most recent id
+ *  first, then reset `allocator`. */
+void
+trace_replay_release(Trace_Replay *r, Allocator allocator);
+
+#endif /* MEM_TRACE_H */
@@ -0,0 +1,244 @@
+#include <stdlib.h> // qsort
+#include <string.h> // memset, strcmp
+
+#include "tracking.h"
+
+void
+tracking_allocator_init(Tracking_Allocator *t, Allocator backing)
+{
+    t->backing = backing;
+    tracking_allocator_reset(t);
+}
+
+void
+tracking_allocator_reset(Tracking_Allocator *t)
+{
+    Allocator backing = t->backing;
+    memset(t, 0, sizeof(*t));
+    t->backing = backing;
+}
+
+static size_t
+internal_tracking_bucket(size_t size)
+{
+    size_t bucket = 0;
+    while (size != 0 && bucket < MEM_TRACKING_HISTOGRAM_BUCKETS - 1) {
+        size   >>= 1;
+        bucket  += 1;
+    }
+    return bucket;
+}
+
+
+/** @brief Find or insert the entry for `location`.
+ *
+ * @return `NULL` if `location` is `NULL` or the table is full.
+ */
+static Tracking_Site *
+internal_tracking_site(Tracking_Allocator *t, const char *location)
+{
+    u64 hash = 14695981039346656037u;
+
+    if (location == NULL) {
+        return NULL;
+    }
+
+    // Hash the contents rather than the address, because the same call site
+    // may be reached through different copies of the same string literal.
+    for (const char *it = location; *it != '\0'; it += 1) {
+        hash ^= cast(uchar)*it;
+        hash *= 1099511628211u;
+    }
+
+    for (size_t i = 0; i < MEM_TRACKING_MAX_SITES; i += 1) {
+        Tracking_Site *site = &t->sites[(hash + i) % MEM_TRACKING_MAX_SITES];
+        if (site->location == NULL) {
+            site->location = location;
+            t->site_count += 1;
+            return site;
+        } else if (site->location == location || strcmp(site->location, location) == 0) {
+            return site;
+        }
+    }
+    return NULL;
+}
+
+static void
+internal_tracking_add(Tracking_Allocator *t, size_t size)
+{
+    t->bytes_in_flight += size;
+    if (t->bytes_in_flight > t->peak_bytes_in_flight) {
+        t->peak_bytes_in_flight = t->bytes_in_flight;
+    }
+}
+
+static void
+internal_tracking_sub(Tracking_Allocator *t, size_t size)
+{
+    t->bytes_in_flight -= (size < t->bytes_in_flight) ? size : t->bytes_in_flight;
+}
+
+static void
+internal_tracking_request(Tracking_Allocator *t, Tracking_Site *site, size_t size)
+{
+    t->bytes_requested += size;
+    t->histogram[internal_tracking_bucket(size)] += 1;
+    if (site != NULL) {
+        site->bytes_requested += size;
+    }
+}
+
+void
+tracking_allocator_free_all(Tracking_Allocator *t)
+{
+    t->free_all_count += 1;
+    t->bytes_in_flight = 0;
+}
+
+static void *
+tracking_allocator_fn(void *context,
+    Allocator_Mode mode,
+    void          *old_ptr,
+    size_t         old_size,
+    size_t         new_size,
+    size_t         align,
+    const char    *location)
+{
+    Tracking_Allocator *t = cast(Tracking_Allocator *)context;
+    Tracking_Site *site;
+    void *ptr;
+
+    ptr  = t->backing.fn(t->backing.context, mode, old_ptr, old_size, new_size,
+        align, location);
+    site = internal_tracking_site(t, location);
+    if (site == NULL) {
+        t->untracked_count += 1;
+    }
+
+    switch (mode) {
+    case ALLOCATOR_RESIZE:
+    case ALLOCATOR_RESIZE_NON_ZEROED:
+        // Resizing to zero is freeing.
+        if (old_ptr != NULL && new_size == 0) {
+            goto free;
+        }
+
+        // Resizing `NULL` is allocating.
+        if (old_ptr != NULL) {
+            t->resize_count += 1;
+            if (site != NULL) {
+                site->resize_count += 1;
+            }
+            internal_tracking_request(t, site, new_size);
+            if (ptr == NULL) {
+                t->failed_count += 1;
+            } else {
+                internal_tracking_sub(t, old_size);
+                internal_tracking_add(t, new_size);
+            }
+            break;
+        }
+        // fallthrough
+    case ALLOCATOR_ALLOC:
+    case ALLOCATOR_ALLOC_NON_ZEROED:
+        t->alloc_count += 1;
+        if (site != NULL) {
+            site->alloc_count += 1;
+        }
+        internal_tracking_request(t, site, new_size);
+        if (ptr == NULL && new_size > 0) {
+            t->failed_count += 1;
+        } else {
+            internal_tracking_add(t, new_size);
+        }
+        break;
+    case ALLOCATOR_FREE:
+free:
+        if (old_ptr == NULL) {
+            break;
+        }
+        t->free_count += 1;
+        if (site != NULL) {
+            site->free_count += 1;
+        }
+        internal_tracking_sub(t, old_size);
+        break;
+    case ALLOCATOR_FREE_ALL:
+        tracking_allocator_free_all(t);
+        break;
+    case ALLOCATOR_TRY_RESIZE_IN_PLACE:
+        // Failing is an expected answer here, not an error.
+        if (ptr != NULL) {
+            t->resize_count += 1;
+            if (site != NULL) {
+                site->resize_count += 1;
+            }
+            internal_tracking_request(t, site, new_size);
+            internal_tracking_sub(t, old_size);
+            internal_tracking_add(t, new_size);
+        }
+        break;
+    }
+    return ptr;
+}
+
+Allocator
+tracking_allocator(Tracking_Allocator *t)
+{
+    Allocator a = {tracking_allocator_fn, t};
+    return a;
+}
+
+static int
+internal_tracking_site_compare(const void *a, const void *b)
+{
+    size_t x = (*cast(const Tracking_Site *const *)a)->bytes_requested;
+    size_t y = (*cast(const Tracking_Site *const *)b)->bytes_requested;
+    // Descending.
+    return (x < y) - (x > y);
+}
+
+void
+tracking_allocator_report(const Tracking_Allocator *t, FILE *stream)
+{
+    const Tracking_Site *order[MEM_TRACKING_MAX_SITES];
+    size_t count = 0;
+
+    fprintf(stream, "allocs: %zu, resizes: %zu, frees: %zu, free alls: %zu, "
+        "failed: %zu\n", t->alloc_count, t->resize_count, t->free_count,
+        t->free_all_count, t->failed_count);
+    fprintf(stream, "bytes requested: %zu, in flight: %zu, peak in flight: %zu\n",
+        t->bytes_requested, t->bytes_in_flight, t->peak_bytes_in_flight);
+
+    fprintf(stream, "size histogram:\n");
+    for (size_t i = 0; i < MEM_TRACKING_HISTOGRAM_BUCKETS; i += 1) {
+        size_t lo, hi;
+
+        if (t->histogram[i] == 0) {
+            continue;
+        }
+        lo = (i == 0) ? 0 : cast(size_t)1 << (i - 1);
+        hi = (i == 0) ? 1 : cast(size_t)1 << i;
+        if (i == MEM_TRACKING_HISTOGRAM_BUCKETS - 1) {
+            fprintf(stream, "    [%10zu, ...       ) bytes: %zu\n", lo, t->histogram[i]);
+        } else {
+            fprintf(stream, "    [%10zu, %10zu) bytes: %zu\n", lo, hi, t->histogram[i]);
+        }
+    }
+
+    for (size_t i = 0; i < MEM_TRACKING_MAX_SITES; i += 1) {
+        if (t->sites[i].location != NULL) {
+            order[count++] = &t->sites[i];
+        }
+    }
+    qsort(cast(void *)order, count, sizeof(order[0]), internal_tracking_site_compare);
+
+    fprintf(stream, "call sites (%zu, %zu requests untracked):\n", count,
+        t->untracked_count);
+    for (size_t i = 0; i < count; i += 1) {
+        const Tracking_Site *site = order[i];
+        fprintf(stream, "    %12zu bytes, %8zu allocs, %8zu resizes, %8zu frees: %s\n",
+            site->bytes_requested, site->alloc_count, site->resize_count,
+            site->free_count, site->location);
+    }
+}
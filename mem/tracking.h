@@ -0,0 +1,91 @@
+#ifndef MEM_TRACKING_H
+#define MEM_TRACKING_H
+
+#include <stdio.h> // FILE
+
+#include "allocator.h"
+
+// Maximum number of distinct call sites recorded. Requests from any further
+// call sites still count towards the totals, just not towards a site.
+#ifndef MEM_TRACKING_MAX_SITES
+#define MEM_TRACKING_MAX_SITES          256
+#endif // MEM_TRACKING_MAX_SITES
+
+// Bucket `i` counts requests of `[2**(i - 1), 2**i)` bytes, with bucket 0
+// counting zero-sized requests. The last bucket takes everything bigger.
+#ifndef MEM_TRACKING_HISTOGRAM_BUCKETS
+#define MEM_TRACKING_HISTOGRAM_BUCKETS  24
+#endif // MEM_TRACKING_HISTOGRAM_BUCKETS
+
+typedef struct Tracking_Site Tracking_Site;
+struct Tracking_Site {
+    // `FILE_LINE_STRING` of the call site, or `NULL` if this slot is unused.
+    const char *location;
+
+    size_t alloc_count;
+    size_t resize_count;
+    size_t free_count;
+
+    // Sum of `new_size` over all allocations and resizes from this site.
+    size_t bytes_requested;
+};
+
+typedef struct Tracking_Allocator Tracking_Allocator;
+struct Tracking_Allocator {
+    Allocator backing;
+
+    size_t alloc_count;
+    size_t resize_count;
+    size_t free_count;
+    size_t free_all_count;
+
+    // Allocations and resizes that the backing allocator failed.
+    size_t failed_count;
+
+    // Sum of `new_size` over all allocations and resizes.
+    size_t bytes_requested;
+
+    // Bytes currently handed out, according to the sizes callers pass in.
+    size_t bytes_in_flight;
+    size_t peak_bytes_in_flight;
+
+    size_t histogram[MEM_TRACKING_HISTOGRAM_BUCKETS];
+
+    // Open-addressed table keyed by `location`.
+    Tracking_Site sites[MEM_TRACKING_MAX_SITES];
+    size_t site_count;
+
+    // Requests whose call site did not fit into `sites`, or had none.
+    size_t untracked_count;
+};
+
+
+/** @brief Forward all requests to `backing`, recording statistics along
+ *  the way. Not thread-safe; give each thread its own tracker. */
+void
+tracking_allocator_init(Tracking_Allocator *t, Allocator backing);
+
+
+/** @brief Clear all statistics, e.g. to only measure a single phase.
+ *  Blocks allocated before this are unknown to the tracker, so freeing them
+ *  afterwards will under-report `bytes_in_flight` (it stops at zero). */
+void
+tracking_allocator_reset(Tracking_Allocator *t);
+
+
+/** @brief Record that every block was released without going through the
+ *  tracker, e.g. by `temp_growing_arena_memory_end` on its backing arena.
+ *  Call this right after, or `bytes_in_flight` never drops. */
+void
+tracking_allocator_free_all(Tracking_Allocator *t);
+
+
+/** @brief Print the totals, the size histogram and every call site to
+ *  `stream`, sites with the most bytes requested first. */
+void
+tracking_allocator_report(const Tracking_Allocator *t, FILE *stream);
+
+Allocator
+tracking_allocator(Tracking_Allocator *t);
+
+#endif /* MEM_TRACKING_H */
@@ -0,0 +1,551 @@
+#include <stdio.h>  // printf
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcpy, strlen
+
+#include <bench.h>
+#include <mem/allocator.c>
+#include <mem/heap.c>
+
+#include "strings.c"
+#include "rope.c"
+#include "utf8.c"
+
+// Size of the generated input, roughly that of a large log file.
+#define BENCH_TEXT_SIZE     (16 * 1024 * 1024)
+#define BENCH_PASSES        10
+
+
+
+/** @brief Fill `buf` with words of `1` to `max_word` letters separated by runs
+ *  of one to three whitespace characters, with a newline every few words. */
+static void
+bench_fill_text(char *buf, size_t len, size_t max_word)
+{
+    static const char spaces[] = {' ', ' ', ' ', '\t', ' ', '\r', ' ', '\n'};
+    size_t i = 0;
+
+    while (i < len) {
+        u64    r    = bench_rng_next();
+        size_t word = 1 + cast(size_t)(r % max_word);
+        size_t gap  = 1 + cast(size_t)((r >> 16) % 3);
+
+        for (; word > 0 && i < len; word -= 1, i += 1) {
+            buf[i] = cast(char)('a' + (r >> 24) % 26);
+        }
+        for (; gap > 0 && i < len; gap -= 1, i += 1) {
+            buf[i] = spaces[(r >> 32) % count_of(spaces)];
+        }
+    }
+}
+
+// Checksum of the tokens seen, so that the loops are not optimized away.
+static volatile size_t
+bench_sink;
+
+
+/** @brief The loop `string_split` used before it was vectorized. */
+static size_t
+bench_split_bytewise(String s)
+{
+    size_t sum   = 0;
+    size_t start = 0;
+
+    for (size_t stop = 0; stop < s.len; stop += 1) {
+        if (char_is_space(s.data[stop])) {
+            if (start != stop) {
+                sum += stop - start;
+            }
+            start = stop + 1;
+        }
+    }
+    if (start < s.len) {
+        sum += s.len - start;
+    }
+    return sum;
+}
+
+static size_t
+bench_split_iterator(String s)
+{
+    String_Split_Iterator it;
+    String token;
+    size_t sum = 0;
+
+    string_split_iterator_init(&it, s);
+    while (string_split_next(&it, &token)) {
+        sum += token.len;
+    }
+    return sum;
+}
+
+/** @brief Same split as `bench_split_iterator`, but through the delimiter
+ *  set kernel rather than the whitespace one. */
+static size_t
+bench_split_token(String s)
+{
+    String_Delimiters d = string_delimiters_from_traits(CHAR_SPACE);
+    String_Split_Iterator it;
+    String token;
+    size_t sum = 0;
+
+    string_split_iterator_init_delimiters(&it, s, &d);
+    while (string_split_next(&it, &token)) {
+        sum += token.len;
+    }
+    return sum;
+}
+
+static size_t
+bench_split_slice(String s)
+{
+    String_Slice list = string_split(s, heap_allocator());
+    size_t sum = 0;
+
+    for (size_t i = 0; i < list.len; i += 1) {
+        sum += list.data[i].len;
+    }
+    array_delete(list.data, list.len, heap_allocator());
+    return sum;
+}
+
+static void
+bench_run(const char *name, String s, size_t (*fn)(String s))
+{
+    u64 start, stop;
+    f64 seconds;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_PASSES; i += 1) {
+        bench_sink = fn(s);
+    }
+    stop = bench_now_ns();
+
+    seconds = cast(f64)(stop - start) / 1e9;
+    printfln("    %-10s %8.1f MiB/s", name,
+        cast(f64)(s.len * BENCH_PASSES) / (1024.0 * 1024.0) / seconds);
+}
+
+/** @brief Check that `fn` sums to `want` on `s`, as timing a wrong answer
+ *  would be pointless.
+ *
+ * @return `true` if it does.
+ */
+static bool
+bench_expect(const char *name, String s, size_t (*fn)(String s), size_t want)
+{
+    size_t got = fn(s);
+    if (got != want) {
+        printfln("    %-10s sums to %zu, want %zu", name, got, want);
+        return false;
+    }
+    return true;
+}
+
+// CLASSIFICATION ========================================================== {{{
+
+// What `char_is_*` and `internal_char_to_digit` in bigint/bigint.c used to
+// do, before they looked up `ASCII_CHAR_TRAITS` and `ASCII_DIGIT_VALUES`.
+
+static bool
+bench_branchy_is_space(char ch)
+{
+    switch (ch) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\r':
+        return true;
+    }
+    return false;
+}
+
+static bool
+bench_branchy_is_alnum(char ch)
+{
+    return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z')
+        || ('0' <= ch && ch <= '9');
+}
+
+static uint
+bench_branchy_digit_value(char ch)
+{
+    if ('0' <= ch && ch <= '9') {
+        return cast(uint)(ch - '0');
+    } else if ('a' <= ch && ch <= 'z') {
+        return cast(uint)(ch - 'a' + 10);
+    } else if ('A' <= ch && ch <= 'Z') {
+        return cast(uint)(ch - 'A' + 10);
+    }
+    return ASCII_DIGIT_INVALID;
+}
+
+static size_t
+bench_classify_branchy(String s)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < s.len; i += 1) {
+        char ch = s.data[i];
+        sum += bench_branchy_is_space(ch);
+        sum += bench_branchy_is_alnum(ch);
+        // Same check as for a number literal in base 16.
+        sum += bench_branchy_digit_value(ch) < 16;
+    }
+    return sum;
+}
+
+static size_t
+bench_classify_table(String s)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < s.len; i += 1) {
+        char ch = s.data[i];
+        sum += char_is_space(ch);
+        sum += char_is_alnum(ch);
+        sum += ascii_is_digit_in_base(ch, 16);
+    }
+    return sum;
+}
+
+
+/** @brief Fill `buf` with a mix of hexadecimal-ish words, punctuation and
+ *  whitespace, so that every branch above is taken unpredictably. */
+static void
+bench_fill_mixed(char *buf, size_t len)
+{
+    static const char alphabet[] = "0123456789abcdefXYZ_,+-*() \t\n";
+    for (size_t i = 0; i < len; i += 1) {
+        buf[i] = alphabet[bench_rng_next() % (sizeof(alphabet) - 1)];
+    }
+}
+
+// === }}} =====================================================================
+
+// DIGITS ================================================================== {{{
+
+// Print every 4 bytes of `s` as a zero-padded 9-digit limb, as
+// `bigint_to_base_lstring` does for base 10.
+
+static u64
+bench_limb_at(String s, size_t i)
+{
+    u32 limb;
+    memcpy(&limb, s.data + i, sizeof(limb));
+    return limb % 1000000000u;
+}
+
+static size_t
+bench_digits_builder(String s)
+{
+    String_Builder sb;
+    size_t len;
+
+    // No `string_builder_reserve`, as the length is rarely known up front.
+    string_builder_init(&sb, heap_allocator());
+    for (size_t i = 0; i + 4 <= s.len; i += 4) {
+        string_write_uint(&sb, bench_limb_at(s, i), 10, 9);
+    }
+    len = sb.len;
+    string_builder_destroy(&sb);
+    return len;
+}
+
+static size_t
+bench_digits_rope(String s)
+{
+    Rope r;
+    size_t len;
+
+    rope_init(&r, 0, heap_allocator());
+    for (size_t i = 0; i + 4 <= s.len; i += 4) {
+        rope_write_uint(&r, bench_limb_at(s, i), 10, 9);
+    }
+    len = r.len;
+    rope_destroy(&r);
+    return len;
+}
+
+// === }}} =====================================================================
+
+// UTF-8 ================================================================== {{{
+
+/** @brief Validate one codepoint at a time, the way a hand-written decoder
+ *  would. */
+static size_t
+bench_utf8_bytewise(String s)
+{
+    const u8 *p = cast(const u8 *)s.data;
+    size_t i = 0;
+
+    while (i < s.len) {
+        u8 b = p[i];
+        size_t len;
+        u32 c;
+
+        if (b < 0x80) {
+            i += 1;
+            continue;
+        } else if ((b & 0xe0) == 0xc0) {
+            len = 2;
+            c   = b & 0x1fu;
+        } else if ((b & 0xf0) == 0xe0) {
+            len = 3;
+            c   = b & 0x0fu;
+        } else if ((b & 0xf8) == 0xf0) {
+            len = 4;
+            c   = b & 0x07u;
+        } else {
+            return i;
+        }
+
+        if (s.len - i < len) {
+            return i;
+        }
+        for (size_t j = 1; j < len; j += 1) {
+            if ((p[i + j] & 0xc0) != 0x80) {
+                return i;
+            }
+            c = (c << 6) | (p[i + j] & 0x3fu);
+        }
+        if ((len == 2 && c < 0x80) || (len == 3 && c < 0x800)
+            || (len == 4 && c < 0x10000) || c > 0x10ffff
+            || (0xd800 <= c && c <= 0xdfff))
+        {
+            return i;
+        }
+        i += len;
+    }
+    return i;
+}
+
+/** @brief Count the bytes that do not continue a sequence, one by one. */
+static size_t
+bench_utf8_count_bytewise(String s)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < s.len; i += 1) {
+        count += (cast(u8)s.data[i] & 0xc0) != 0x80;
+    }
+    return count;
+}
+
+static size_t
+bench_utf8_validate(String s)
+{
+    return utf8_find_invalid(s);
+}
+
+static size_t
+bench_utf8_count(String s)
+{
+    return utf8_count(s);
+}
+
+
+/** @brief Check `utf8_find_invalid`, `utf8_is_valid` and `utf8_count`
+ *  against the bytewise versions on `s`.
+ *
+ * @return `true` if they agree.
+ */
+static bool
+bench_utf8_agree(String s)
+{
+    size_t want_invalid = bench_utf8_bytewise(s);
+    size_t want_count   = bench_utf8_count_bytewise(s);
+    size_t got_invalid  = utf8_find_invalid(s);
+    size_t got_count    = utf8_count(s);
+
+    if (got_invalid != want_invalid || utf8_is_valid(s) != (want_invalid == s.len)
+        || got_count != want_count)
+    {
+        printfln("utf-8 mismatch in %zu bytes: invalid at %zu (want %zu), "
+            "%zu codepoints (want %zu)", s.len, got_invalid, want_invalid,
+            got_count, want_count);
+        return false;
+    }
+    return true;
+}
+
+
+/** @brief Check the UTF-8 kernels on every sample below, placed at each
+ *  offset around the 16-, 32- and 64-byte boundaries, after ASCII or 2-byte
+ *  sequences and with or without valid text after it. Then on short runs
+ *  of random bytes weighted towards the interesting ones.
+ *
+ * @return `true` if they always agree with the bytewise versions.
+ */
+static bool
+bench_utf8_check(void)
+{
+    static const char *const samples[] = {
+        // Valid, including the edges of each range.
+        "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf", "\xee\x80\x80",
+        "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf",
+        // Truncated, possibly by the end of the input.
+        "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\xe2\x82" "a",
+        // Overlong.
+        "\xc0\xaf", "\xc1\xbf", "\xe0\x80\xaf", "\xe0\x9f\xbf", "\xf0\x80\x80\xaf",
+        "\xf0\x8f\xbf\xbf",
+        // Surrogates.
+        "\xed\xa0\x80", "\xed\xbf\xbf",
+        // Past U+10FFFF, or never valid.
+        "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xf8\x88\x80\x80\x80", "\xfe", "\xff",
+        // Stray continuations.
+        "\x80", "\xbf", "\xc3\xa9\xa9", "\xf0\x9f\x98\x80\x80",
+    };
+    static const char trailer[] = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"
+        "0123456789abcdef\xe4\xb8\xad\xd0\xb6 and some more ascii text";
+    static const u8 alphabet[] = {'a', ' ', 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0,
+        0xbf, 0xc0, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4, 0xf5, 0xff};
+    char buf[160];
+
+    for (size_t i = 0; i < count_of(samples); i += 1) {
+        size_t n = strlen(samples[i]);
+
+        for (size_t offset = 0; offset <= 80; offset += 1) {
+            for (int two_byte = 0; two_byte < 2; two_byte += 1) {
+                size_t len = 0;
+
+                for (; len < offset; len += 1) {
+                    buf[len] = 'a';
+                    if (two_byte && offset - len >= 2) {
+                        buf[len]     = cast(char)0xc3;
+                        buf[len + 1] = cast(char)0xa9;
+                        len += 1;
+                    }
+                }
+                memcpy(buf + len, samples[i], n);
+                len += n;
+                if (!bench_utf8_agree((String){buf, len})) {
+                    return false;
+                }
+                memcpy(buf + len, trailer, sizeof(trailer) - 1);
+                len += sizeof(trailer) - 1;
+                if (!bench_utf8_agree((String){buf, len})) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < 100000; i += 1) {
+        size_t len = cast(size_t)(bench_rng_next() % sizeof(buf));
+        for (size_t j = 0; j < len; j += 1) {
+            u64 r = bench_rng_next();
+            // Mostly ASCII, so that some runs stay valid for a while.
+            buf[j] = (r & 1) ? 'a' : cast(char)alphabet[(r >> 8) % count_of(alphabet)];
+        }
+        if (!bench_utf8_agree((String){buf, len})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** @brief Fill `buf` with valid UTF-8, `ascii_percent`% of codepoints being
+ *  ASCII and the rest spread over 2-, 3- and 4-byte sequences. */
+static void
+bench_fill_utf8(char *buf, size_t len, u64 ascii_percent)
+{
+    static const char *const samples[] = {"\xc3\xa9", "\xd0\xb6", "\xe2\x82\xac",
+        "\xe4\xb8\xad", "\xf0\x9f\x98\x80"};
+    size_t i = 0;
+
+    while (i < len) {
+        const char *c = "a";
+        size_t n;
+
+        if (bench_rng_next() % 100 >= ascii_percent) {
+            c = samples[bench_rng_next() % count_of(samples)];
+        }
+        n = strlen(c);
+        if (n > len - i) {
+            c = " ";
+            n = 1;
+        }
+        memcpy(buf + i, c, n);
+        i += n;
+    }
+}
+
+// === }}} =====================================================================
+
+int
+main(void)
+{
+    static const size_t max_words[] = {4, 12, 64};
+    static const u64 ascii_percents[] = {100, 90, 50, 0};
+    char *buf = cast(char *)malloc(BENCH_TEXT_SIZE);
+    String s  = {buf, BENCH_TEXT_SIZE};
+    size_t want;
+
+    if (buf == NULL) {
+        eprintln("Out of memory");
+        return 1;
+    }
+
+#if defined(UTILS_STRINGS_SIMD_WIDTH)
+    printfln("whitespace kernel: %i bytes per step", UTILS_STRINGS_SIMD_WIDTH);
+#else
+    println("whitespace kernel: scalar");
+#endif // UTILS_STRINGS_SIMD_WIDTH
+#if defined(UTILS_STRINGS_SHUFFLE_WIDTH)
+    printfln("delimiter kernel: %i bytes per step", UTILS_STRINGS_SHUFFLE_WIDTH);
+#else
+    println("delimiter kernel: scalar");
+#endif // UTILS_STRINGS_SHUFFLE_WIDTH
+
+    for (size_t i = 0; i < count_of(max_words); i += 1) {
+        bench_fill_text(buf, BENCH_TEXT_SIZE, max_words[i]);
+        printfln("words of 1..%zu letters:", max_words[i]);
+        want = bench_split_bytewise(s);
+        if (!bench_expect("iterator", s, bench_split_iterator, want)
+            || !bench_expect("token", s, bench_split_token, want)
+            || !bench_expect("split", s, bench_split_slice, want))
+        {
+            free(buf);
+            return 1;
+        }
+        bench_run("bytewise", s, bench_split_bytewise);
+        bench_run("iterator", s, bench_split_iterator);
+        bench_run("token", s, bench_split_token);
+        bench_run("split", s, bench_split_slice);
+    }
+
+    bench_fill_mixed(buf, BENCH_TEXT_SIZE);
+    println("classify space, alnum and base-16 digits:");
+    bench_run("branchy", s, bench_classify_branchy);
+    bench_run("table", s, bench_classify_table);
+
+#if defined(UTILS_UTF8_SIMD_WIDTH)
+    printfln("utf-8 kernel: %i bytes per step", UTILS_UTF8_SIMD_WIDTH);
+#else
+    println("utf-8 kernel: scalar");
+#endif // UTILS_UTF8_SIMD_WIDTH
+    if (!bench_utf8_check()) {
+        free(buf);
+        return 1;
+    }
+    println("utf-8: matches the bytewise validator and count");
+
+    for (size_t i = 0; i < count_of(ascii_percents); i += 1) {
+        bench_fill_utf8(buf, BENCH_TEXT_SIZE, ascii_percents[i]);
+        printfln("utf-8, %i%% ascii:", cast(int)ascii_percents[i]);
+        // Also without the last byte, which may cut a codepoint short.
+        if (!bench_utf8_agree(s) || !bench_utf8_agree((String){buf, BENCH_TEXT_SIZE - 1})) {
+            free(buf);
+            return 1;
+        }
+        bench_run("bytewise", s, bench_utf8_bytewise);
+        bench_run("validate", s, bench_utf8_validate);
+        bench_run("count", s, bench_utf8_count);
+    }
+
+    println("print 9-digit limbs:");
+    bench_run("builder", s, bench_digits_builder);
+    bench_run("rope", s, bench_digits_rope);
+
+    free(buf);
+    return 0;
+}
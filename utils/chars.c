@@ -2,14 +2,16 @@
 
 #define TRAITS_SPACE_CNTRL     (CHAR_CNTRL | CHAR_SPACE)
 #define TRAITS_PUNCT           (CHAR_PRINT | CHAR_GRAPH | CHAR_PUNCT)
+#define TRAITS_DIGIT           (CHAR_PRINT | CHAR_GRAPH | CHAR_DIGIT | CHAR_XDIGIT)
 #define TRAITS_UPPER           (CHAR_PRINT | CHAR_GRAPH | CHAR_UPPER)
 #define TRAITS_UPPER_XDIGIT    (TRAITS_UPPER | CHAR_XDIGIT)
 #define TRAITS_LOWER           (CHAR_PRINT | CHAR_GRAPH | CHAR_LOWER)
 #define TRAITS_LOWER_XDIGIT    (TRAITS_LOWER | CHAR_XDIGIT)
 
-/** @link https://en.cppreference.com/w/c/string/byte/isalpha.html */
+/** @link https://en.cppreference.com/w/c/string/byte/isalpha.html
+ *  Bytes past the ASCII range have no traits. */
 const u16
-ASCII_CHAR_TRAITS[CHAR_MAX + 1] = {
+ASCII_CHAR_TRAITS[UCHAR_MAX + 1] = {
     // Control Codes (NUL, etc.)
     CHAR_CNTRL, CHAR_CNTRL, CHAR_CNTRL, CHAR_CNTRL, CHAR_CNTRL, CHAR_CNTRL,
     CHAR_CNTRL, CHAR_CNTRL, CHAR_CNTRL,
@@ -31,6 +33,14 @@ ASCII_CHAR_TRAITS[CHAR_MAX + 1] = {
     TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT,
     TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT,
 
+    // Digits: 0123456789
+    TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT,
+    TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT, TRAITS_DIGIT,
+
+    // Punctuations: :;<=>?@
+    TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT, TRAITS_PUNCT,
+    TRAITS_PUNCT, TRAITS_PUNCT,
+
     // Uppercase: ABCDEF
     TRAITS_UPPER_XDIGIT, TRAITS_UPPER_XDIGIT, TRAITS_UPPER_XDIGIT,
     TRAITS_UPPER_XDIGIT, TRAITS_UPPER_XDIGIT, TRAITS_UPPER_XDIGIT,
@@ -62,9 +72,36 @@ ASCII_CHAR_TRAITS[CHAR_MAX + 1] = {
     CHAR_CNTRL,
 };
 
+#define XX  ASCII_DIGIT_INVALID
+
+const u8
+ASCII_DIGIT_VALUES[UCHAR_MAX + 1] = {
+    // 16 bytes per row.
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    // Bytes past the ASCII range.
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+};
+
+#undef XX
+
 // Macro cleanup
 #undef TRAITS_SPACE_CNTRL
 #undef TRAITS_PUNCT
+#undef TRAITS_DIGIT
 #undef TRAITS_UPPER
 #undef TRAITS_UPPER_XDIGIT
 #undef TRAITS_LOWER
@@ -22,13 +22,31 @@ enum Char_Trait {
     CHAR_ALNUM  = CHAR_ALPHA | CHAR_DIGIT,
 };
 
+// Indexed by any byte, not just ASCII, so that classifying is a single load.
 extern const u16
-ASCII_CHAR_TRAITS[CHAR_MAX + 1];
+ASCII_CHAR_TRAITS[UCHAR_MAX + 1];
 
-#define ascii_has_trait(ch, trait)  (ASCII_CHAR_TRAITS[(int)ch] & (trait))
+#define ascii_has_trait(ch, trait)  (ASCII_CHAR_TRAITS[(uchar)(ch)] & (trait))
 
 #define ascii_is_digit(ch)  ascii_has_trait(ch, CHAR_DIGIT)
 #define ascii_is_upper(ch)  ascii_has_trait(ch, CHAR_UPPER)
 #define ascii_is_lower(ch)  ascii_has_trait(ch, CHAR_LOWER)
+#define ascii_is_alpha(ch)  ascii_has_trait(ch, CHAR_ALPHA)
+#define ascii_is_alnum(ch)  ascii_has_trait(ch, CHAR_ALNUM)
+#define ascii_is_space(ch)  ascii_has_trait(ch, CHAR_SPACE)
+#define ascii_is_xdigit(ch) ascii_has_trait(ch, CHAR_XDIGIT)
+#define ascii_is_punct(ch)  ascii_has_trait(ch, CHAR_PUNCT)
+
+// Digit value of bytes that are not digits in any base up to 36.
+#define ASCII_DIGIT_INVALID 0xff
+
+// Value of the digit `ch` in bases up to 36, case-insensitive, e.g. 'F' is 15.
+// Otherwise `ASCII_DIGIT_INVALID`, which is never less than a base.
+extern const u8
+ASCII_DIGIT_VALUES[UCHAR_MAX + 1];
+
+#define ascii_digit_value(ch)   ASCII_DIGIT_VALUES[(uchar)(ch)]
+
+#define ascii_is_digit_in_base(ch, base)    (ascii_digit_value(ch) < (base))
 
 #endif /* PROJECT_CHARS_H */
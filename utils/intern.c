@@ -0,0 +1,167 @@
+#include <string.h> // memcmp, memcpy
+
+#include "intern.h"
+
+// Grow once more than this fraction of the slots would be in use.
+#define INTERN_MAX_LOAD_NUMERATOR   3
+#define INTERN_MAX_LOAD_DENOMINATOR 4
+
+#define INTERN_MIN_CAP  32
+
+void
+intern_init(Intern *in, Allocator backing)
+{
+    in->slots   = NULL;
+    in->count   = 0;
+    in->cap     = 0;
+    in->backing = backing;
+    growing_arena_init(&in->storage, /*block_size=*/0, backing);
+}
+
+void
+intern_destroy(Intern *in)
+{
+    array_delete(in->slots, in->cap, in->backing);
+    growing_arena_destroy(&in->storage);
+    in->slots = NULL;
+    in->count = 0;
+    in->cap   = 0;
+}
+
+u32
+intern_hash(String s)
+{
+    // Multiplier from Fibonacci hashing: 2**64 divided by the golden ratio.
+    const u64 K = 0x9e3779b97f4a7c15u;
+    u64 hash    = K ^ s.len;
+    size_t i    = 0;
+
+    // Mix in 8 bytes at a time, then whatever is left zero-padded.
+    for (; i + sizeof(u64) <= s.len; i += sizeof(u64)) {
+        u64 word;
+        memcpy(&word, s.data + i, sizeof(word));
+        hash = (hash ^ word) * K;
+        hash ^= hash >> 32;
+    }
+    if (i < s.len) {
+        u64 word = 0;
+        memcpy(&word, s.data + i, s.len - i);
+        hash = (hash ^ word) * K;
+    }
+
+    // Multiplying only carries upwards, so fold the high bits back down
+    // (MurmurHash3's finalizer); slots are picked by the low bits.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdu;
+    hash ^= hash >> 33;
+    return cast(u32)hash;
+}
+
+/** @brief The slot holding `s`, or the empty slot where it would go. */
+static Intern_Slot *
+internal_intern_probe(const Intern *in, String s, u32 hash)
+{
+    size_t mask = in->cap - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Intern_Slot *slot = &in->slots[i];
+        if (slot->string == NULL) {
+            return slot;
+        }
+
+        if (slot->hash == hash
+            && slot->string->len == s.len
+            && memcmp(slot->string->data, s.data, s.len) == 0)
+        {
+            return slot;
+        }
+    }
+}
+
+static bool
+internal_intern_grow(Intern *in)
+{
+    Intern_Slot *old_slots = in->slots;
+    size_t old_cap = in->cap;
+    size_t new_cap = (old_cap == 0) ? INTERN_MIN_CAP : old_cap * 2;
+
+    in->slots = array_make(Intern_Slot, new_cap, in->backing);
+    if (in->slots == NULL) {
+        in->slots = old_slots;
+        return false;
+    }
+    in->cap = new_cap;
+
+    // Every string is already unique, so just find the first empty slot.
+    for (size_t i = 0; i < old_cap; i += 1) {
+        Intern_Slot *slot = &old_slots[i];
+        if (slot->string != NULL) {
+            size_t j = slot->hash & (new_cap - 1);
+            while (in->slots[j].string != NULL) {
+                j = (j + 1) & (new_cap - 1);
+            }
+            in->slots[j] = *slot;
+        }
+    }
+    array_delete(old_slots, old_cap, in->backing);
+    return true;
+}
+
+Intern_String *
+intern_get(Intern *in, String s)
+{
+    u32 hash = intern_hash(s);
+    Intern_String *string;
+    Intern_Slot *slot;
+
+    if (in->cap > 0) {
+        slot = internal_intern_probe(in, s, hash);
+        if (slot->string != NULL) {
+            return slot->string;
+        }
+    }
+
+    // Not yet interned, so make room for one more.
+    if ((in->count + 1) * INTERN_MAX_LOAD_DENOMINATOR
+        > in->cap * INTERN_MAX_LOAD_NUMERATOR)
+    {
+        if (!internal_intern_grow(in)) {
+            return NULL;
+        }
+    }
+
+    string = cast(Intern_String *)growing_arena_alloc_align_non_zeroed(&in->storage,
+        sizeof(*string) + s.len + 1, alignof(Intern_String));
+    if (string == NULL) {
+        return NULL;
+    }
+    string->tag  = 0;
+    string->hash = hash;
+    string->len  = s.len;
+    if (s.len > 0) {
+        memcpy(string->data, s.data, s.len);
+    }
+    string->data[s.len] = '\0';
+
+    // Probe again, as growing may have moved everything.
+    slot         = internal_intern_probe(in, s, hash);
+    slot->hash   = hash;
+    slot->string = string;
+    in->count   += 1;
+    return string;
+}
+
+Intern_String *
+intern_find(const Intern *in, String s)
+{
+    if (in->cap == 0) {
+        return NULL;
+    }
+    return internal_intern_probe(in, s, intern_hash(s))->string;
+}
+
+String
+intern_to_string(const Intern_String *s)
+{
+    String t = {s->data, s->len};
+    return t;
+}
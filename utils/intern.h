@@ -0,0 +1,80 @@
+#ifndef UTILS_INTERN_H
+#define UTILS_INTERN_H
+
+#include <mem/growing_arena.h>
+
+#include "strings.h"
+
+/**
+ * @brief A string that was interned exactly once. Two interned strings from
+ *  the same table are equal if and only if their pointers are.
+ *
+ * @note
+ *  Like `Ostring` in lulu, the bytes are stored right after the header and
+ *  are nul-terminated.
+ */
+typedef struct Intern_String Intern_String;
+struct Intern_String {
+    // Caller-defined, e.g. the token type of a keyword. 0 if never set.
+    int tag;
+
+    // Hash value of `data[:len]`, as returned by `intern_hash`.
+    u32 hash;
+
+    size_t len;
+    char   data[];
+};
+
+// Slots keep a copy of the hash so that probing rarely touches the strings.
+typedef struct Intern_Slot Intern_Slot;
+struct Intern_Slot {
+    u32            hash;
+    Intern_String *string;
+};
+
+typedef struct Intern Intern;
+struct Intern {
+    // Open-addressed with linear probing. `cap` is 0 or a power of 2, and
+    // empty slots have a `NULL` string.
+    Intern_Slot *slots;
+    size_t       count;
+    size_t       cap;
+
+    // Owns the `Intern_String`s, which are never freed individually.
+    Growing_Arena storage;
+
+    // Owns `slots` and the blocks of `storage`.
+    Allocator backing;
+};
+
+void
+intern_init(Intern *in, Allocator backing);
+
+
+/** @brief Free the table along with every string in it. */
+void
+intern_destroy(Intern *in);
+
+
+/** @brief Hash `s` a word at a time. Not stable across byte orders. */
+u32
+intern_hash(String s);
+
+
+/** @brief Reuse the interned copy of `s`, or make a new one.
+ *
+ * @return `NULL` if out of memory.
+ */
+Intern_String *
+intern_get(Intern *in, String s);
+
+
+/** @brief The interned copy of `s`, or `NULL` if there is none. Never
+ *  allocates. */
+Intern_String *
+intern_find(const Intern *in, String s);
+
+String
+intern_to_string(const Intern_String *s);
+
+#endif /* UTILS_INTERN_H */
@@ -0,0 +1,306 @@
+#include <stdio.h>  // fwrite, fflush, fileno
+#include <string.h> // memcpy, memset
+
+#if !defined(UTILS_ROPE_NO_WRITEV) \
+    && (defined(_POSIX_C_SOURCE) || defined(__APPLE__))
+#include <errno.h>   // errno, EINTR
+#include <limits.h>  // IOV_MAX
+#include <sys/uio.h> // writev, struct iovec
+#define UTILS_ROPE_WRITEV
+#endif // POSIX
+
+#include "rope.h"
+
+#ifdef UTILS_ROPE_WRITEV
+
+// At most this many chunks per `writev` call. POSIX only guarantees 16.
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define ROPE_IOV_BATCH  IOV_MAX
+#else // !IOV_MAX || IOV_MAX >= 64
+#define ROPE_IOV_BATCH  64
+#endif // IOV_MAX
+
+#endif // UTILS_ROPE_WRITEV
+
+void
+rope_init(Rope *r, size_t chunk_size, Allocator allocator)
+{
+    if (chunk_size == 0) {
+        chunk_size = UTILS_ROPE_CHUNK_SIZE;
+    } else if (chunk_size < ROPE_MIN_CHUNK_SIZE) {
+        chunk_size = ROPE_MIN_CHUNK_SIZE;
+    }
+    r->head       = NULL;
+    r->tail       = NULL;
+    r->len        = 0;
+    r->chunk_size = chunk_size;
+    r->allocator  = allocator;
+}
+
+void
+rope_destroy(Rope *r)
+{
+    Rope_Chunk *chunk = r->head;
+    while (chunk != NULL) {
+        Rope_Chunk *next = chunk->next;
+        mem_free(chunk, sizeof(*chunk) + r->chunk_size, r->allocator);
+        chunk = next;
+    }
+    r->head = NULL;
+    r->tail = NULL;
+    r->len  = 0;
+}
+
+void
+rope_clear(Rope *r)
+{
+    for (Rope_Chunk *chunk = r->head; chunk != NULL; chunk = chunk->next) {
+        chunk->len = 0;
+    }
+    r->tail = r->head;
+    r->len  = 0;
+}
+
+
+/** @brief Move `r->tail` to an empty chunk, reusing a cleared one if any. */
+static bool
+internal_rope_next_chunk(Rope *r)
+{
+    Rope_Chunk *chunk;
+
+    if (r->tail != NULL && r->tail->next != NULL) {
+        r->tail = r->tail->next;
+        return true;
+    }
+
+    chunk = cast(Rope_Chunk *)mem_alloc_align_non_zeroed(
+        sizeof(*chunk) + r->chunk_size, alignof(Rope_Chunk), r->allocator);
+    if (chunk == NULL) {
+        return false;
+    }
+    chunk->next = NULL;
+    chunk->len  = 0;
+
+    if (r->tail == NULL) {
+        r->head = chunk;
+    } else {
+        r->tail->next = chunk;
+    }
+    r->tail = chunk;
+    return true;
+}
+
+static size_t
+internal_rope_available(const Rope *r)
+{
+    return (r->tail == NULL) ? 0 : r->chunk_size - r->tail->len;
+}
+
+char *
+rope_extend(Rope *r, size_t n)
+{
+    char *out;
+
+    assert(0 < n && n <= r->chunk_size);
+    if (internal_rope_available(r) < n && !internal_rope_next_chunk(r)) {
+        return NULL;
+    }
+
+    out           = r->tail->data + r->tail->len;
+    r->tail->len += n;
+    r->len       += n;
+    return out;
+}
+
+bool
+rope_write_string(Rope *r, const char *data, size_t len)
+{
+    while (len > 0) {
+        size_t n = internal_rope_available(r);
+        if (n == 0) {
+            if (!internal_rope_next_chunk(r)) {
+                return false;
+            }
+            n = r->chunk_size;
+        }
+        if (n > len) {
+            n = len;
+        }
+
+        memcpy(r->tail->data + r->tail->len, data, n);
+        r->tail->len += n;
+        r->len       += n;
+        data         += n;
+        len          -= n;
+    }
+    return true;
+}
+
+bool
+rope_write_char(Rope *r, char c)
+{
+    char *out = rope_extend(r, 1);
+    if (out == NULL) {
+        return false;
+    }
+    *out = c;
+    return true;
+}
+
+bool
+rope_write_repeat(Rope *r, char c, size_t n)
+{
+    while (n > 0) {
+        size_t avail = internal_rope_available(r);
+        if (avail == 0) {
+            if (!internal_rope_next_chunk(r)) {
+                return false;
+            }
+            avail = r->chunk_size;
+        }
+        if (avail > n) {
+            avail = n;
+        }
+
+        memset(r->tail->data + r->tail->len, c, avail);
+        r->tail->len += avail;
+        r->len       += avail;
+        n            -= avail;
+    }
+    return true;
+}
+
+bool
+rope_write_uint(Rope *r, u64 value, uint base, size_t min_digits)
+{
+    size_t n = string_uint_length(value, base);
+    char *out;
+
+    // Keep the digits themselves in one chunk, so they can be written right
+    // to left. Only the padding may span chunks.
+    if (n < min_digits && !rope_write_repeat(r, '0', min_digits - n)) {
+        return false;
+    }
+
+    out = rope_extend(r, n);
+    if (out == NULL) {
+        return false;
+    }
+    string_format_uint(out, n, value, base);
+    return true;
+}
+
+bool
+rope_write_int(Rope *r, i64 value, uint base, size_t min_digits)
+{
+    u64 magnitude = cast(u64)value;
+
+    if (value < 0) {
+        if (!rope_write_char(r, '-')) {
+            return false;
+        }
+        // Well-defined even for `I64_MIN`.
+        magnitude = 0 - magnitude;
+    }
+    return rope_write_uint(r, magnitude, base, min_digits);
+}
+
+#ifdef UTILS_ROPE_WRITEV
+
+/** @brief Write all of `iov[:count]` to `fd`, resuming after short writes. */
+static bool
+internal_rope_writev_all(int fd, struct iovec *iov, int count)
+{
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+        size_t  rest;
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // Skip the buffers that were written in full, then trim the first
+        // one that was not.
+        rest = cast(size_t)written;
+        while (count > 0 && rest >= iov->iov_len) {
+            rest  -= iov->iov_len;
+            iov   += 1;
+            count -= 1;
+        }
+        if (count > 0) {
+            iov->iov_base  = cast(char *)iov->iov_base + rest;
+            iov->iov_len  -= rest;
+        }
+    }
+    return true;
+}
+
+bool
+rope_write_file(const Rope *r, FILE *stream)
+{
+    struct iovec iov[ROPE_IOV_BATCH];
+    int count = 0;
+    int fd;
+
+    // Anything still buffered in `stream` must come out first.
+    if (fflush(stream) != 0) {
+        return false;
+    }
+
+    fd = fileno(stream);
+    for (const Rope_Chunk *chunk = r->head; chunk != NULL; chunk = chunk->next) {
+        if (chunk->len == 0) {
+            continue;
+        }
+        iov[count].iov_base = cast(void *)chunk->data;
+        iov[count].iov_len  = chunk->len;
+        count += 1;
+        if (count == ROPE_IOV_BATCH) {
+            if (!internal_rope_writev_all(fd, iov, count)) {
+                return false;
+            }
+            count = 0;
+        }
+    }
+    return internal_rope_writev_all(fd, iov, count);
+}
+
+#else // !UTILS_ROPE_WRITEV
+
+bool
+rope_write_file(const Rope *r, FILE *stream)
+{
+    for (const Rope_Chunk *chunk = r->head; chunk != NULL; chunk = chunk->next) {
+        if (fwrite(chunk->data, 1, chunk->len, stream) != chunk->len) {
+            return false;
+        }
+    }
+    return fflush(stream) == 0;
+}
+
+#endif // UTILS_ROPE_WRITEV
+
+String
+rope_flatten(const Rope *r, Allocator allocator)
+{
+    String res = {NULL, 0};
+    char *data;
+    size_t len = 0;
+
+    data = array_make_non_zeroed(char, r->len + 1, allocator);
+    if (data == NULL) {
+        return res;
+    }
+    for (const Rope_Chunk *chunk = r->head; chunk != NULL; chunk = chunk->next) {
+        memcpy(data + len, chunk->data, chunk->len);
+        len += chunk->len;
+    }
+    data[len] = '\0';
+
+    res.data = data;
+    res.len  = len;
+    return res;
+}
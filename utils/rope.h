@@ -0,0 +1,121 @@
+#ifndef UTILS_ROPE_H
+#define UTILS_ROPE_H
+
+#include <stdio.h> // FILE
+
+#include "strings.h"
+
+// Bytes of text per chunk when `rope_init` is given a size of 0.
+#ifndef UTILS_ROPE_CHUNK_SIZE
+#define UTILS_ROPE_CHUNK_SIZE   (64 * 1024)
+#endif // UTILS_ROPE_CHUNK_SIZE
+
+// Smallest chunk size, so that any `u64` fits in one chunk even in base 2.
+#define ROPE_MIN_CHUNK_SIZE     64
+
+// The text lives right after the header.
+typedef struct Rope_Chunk Rope_Chunk;
+struct Rope_Chunk {
+    Rope_Chunk *next;
+
+    // Number of bytes in use in `data[:Rope.chunk_size]`.
+    size_t len;
+    char   data[];
+};
+
+/**
+ * @brief Text written to a list of fixed-size chunks. Unlike with a
+ *  `String_Builder`, writes never move what was already written, so the
+ *  cost per byte stays the same no matter how long the text gets.
+ *
+ * @note
+ *  The text is not contiguous; see `rope_write_file` and `rope_flatten`.
+ *
+ *  `rope_write_file` uses `writev` where available. On glibc it needs
+ *  `_DEFAULT_SOURCE` (or `_POSIX_C_SOURCE`) under `-std=c11`, for `fileno`.
+ *  Otherwise every chunk goes through `fwrite`.
+ */
+typedef struct Rope Rope;
+struct Rope {
+    // Chunks past `tail` are empty, kept by `rope_clear` for reuse.
+    Rope_Chunk *head;
+    Rope_Chunk *tail;
+
+    // Total number of bytes written, across all chunks.
+    size_t len;
+    size_t chunk_size;
+
+    // Owns the chunks.
+    Allocator allocator;
+};
+
+
+/** @param chunk_size  0 for `UTILS_ROPE_CHUNK_SIZE`. Raised to
+ *  `ROPE_MIN_CHUNK_SIZE` if less. */
+void
+rope_init(Rope *r, size_t chunk_size, Allocator allocator);
+
+void
+rope_destroy(Rope *r);
+
+
+/** @brief Empty `r`, but keep its chunks to write to again, e.g. after
+ *  `rope_write_file`. */
+void
+rope_clear(Rope *r);
+
+
+/** @brief Append `n` uninitialized contiguous bytes to `r`, to be filled in
+ *  directly by the caller. Starts a new chunk if the last one has less than
+ *  `n` bytes left, leaving the rest of it unused.
+ *
+ * @param n  In the range `[1, r->chunk_size]`.
+ *
+ * @return The first of the new bytes, or `NULL` if out of memory.
+ */
+char *
+rope_extend(Rope *r, size_t n);
+
+#define rope_write_literal(r, s)    rope_write_string(r, s, sizeof(s) - 1)
+
+bool
+rope_write_string(Rope *r, const char *data, size_t len);
+
+bool
+rope_write_char(Rope *r, char c);
+
+
+/** @brief Write `c` `n` times. */
+bool
+rope_write_repeat(Rope *r, char c, size_t n);
+
+
+/** @brief Same as `string_write_uint`. */
+bool
+rope_write_uint(Rope *r, u64 value, uint base, size_t min_digits);
+
+
+/** @brief Same as `string_write_int`. */
+bool
+rope_write_int(Rope *r, i64 value, uint base, size_t min_digits);
+
+
+/** @brief Write the text of `r` to `stream`, after whatever `stream` had
+ *  buffered, without copying it into one buffer first. Flushes `stream`.
+ *
+ * @return `false` on a write error, after which an unknown prefix of the
+ *  text may have been written.
+ */
+bool
+rope_write_file(const Rope *r, FILE *stream);
+
+
+/** @brief Copy the text of `r` into a single nul-terminated buffer from
+ *  `allocator`.
+ *
+ * @return The string, with `data == NULL` if out of memory.
+ */
+String
+rope_flatten(const Rope *r, Allocator allocator);
+
+#endif /* UTILS_ROPE_H */
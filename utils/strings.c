@@ -1,52 +1,71 @@
 #include <string.h>
 
 #include "strings.h"
+#include "chars.c"
+
+// Define to use the portable kernel even when SSE2 or AVX2 is available, e.g.
+// to compare against them.
+// #define UTILS_STRINGS_NO_SIMD
+
+#if !defined(UTILS_STRINGS_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h> // _mm256_*
+#define UTILS_STRINGS_SIMD_WIDTH    32
+#elif !defined(UTILS_STRINGS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h> // _mm_*
+#define UTILS_STRINGS_SIMD_WIDTH    16
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Portable fallback: 8 bytes at a time in a `u64` ("SIMD within a register").
+#define UTILS_STRINGS_SIMD_WIDTH    8
+#endif // UTILS_STRINGS_NO_SIMD
+
+// Arbitrary delimiter sets need a byte shuffle (`pshufb`) to look up a table,
+// which SSE2 lacks. Without one, they are classified a byte at a time.
+#if !defined(UTILS_STRINGS_NO_SIMD) && defined(__AVX2__)
+#define UTILS_STRINGS_SHUFFLE_WIDTH 32
+#elif !defined(UTILS_STRINGS_NO_SIMD) && defined(__SSSE3__)
+#include <tmmintrin.h> // _mm_shuffle_epi8
+#define UTILS_STRINGS_SHUFFLE_WIDTH 16
+#endif // UTILS_STRINGS_NO_SIMD
+
+// Bytes classified per `String_Split_Iterator.mask`, one per bit.
+#define UTILS_STRINGS_BLOCK_SIZE    64
 
 bool
 char_is_alpha(char ch)
 {
-    return char_is_upper(ch) || char_is_lower(ch);
+    return ascii_is_alpha(ch) != 0;
 }
 
 bool
 char_is_alnum(char ch)
 {
-    return char_is_alpha(ch) || char_is_digit(ch);
+    return ascii_is_alnum(ch) != 0;
 }
 
 bool
 char_is_digit(char ch)
 {
-    return '0' <= ch && ch <= '9';
+    return ascii_is_digit(ch) != 0;
 }
 
 bool
 char_is_upper(char ch)
 {
-    return 'A' <= ch && ch <= 'Z';
+    return ascii_is_upper(ch) != 0;
 }
 
 bool
 char_is_lower(char ch)
 {
-    return 'a' <= ch && ch <= 'z';
+    return ascii_is_lower(ch) != 0;
 }
 
 bool
 char_is_space(char ch)
 {
-    switch (ch) {
-    case ' ':
-    case '\t':
-    case '\n':
-    case '\v':
-    case '\r':
-        return true;
-    }
-    return false;
+    return ascii_is_space(ch) != 0;
 }
 
-
 String
 string_sub(String s, size_t start, size_t stop)
 {
@@ -55,39 +74,411 @@ string_sub(String s, size_t start, size_t stop)
     return t;
 }
 
-String_Slice
-string_split(String s, Allocator allocator)
+// DELIMITERS ============================================================== {{{
+
+static void
+internal_string_delimiters_set(String_Delimiters *d, uchar ch)
 {
-    String_Dynamic d;
-    string_dynamic_init(&d, allocator);
-
-    size_t start = 0;
-    for (size_t stop = 0; stop < s.len; stop += 1) {
-        char c = s.data[stop];
-        // Split on whitespaces.
-        if (char_is_space(c)) {
-            // Mark substring (if any) before splitting the whitespace.
-            if (start != stop) {
-                if (!string_dynamic_append(&d, string_sub(s, start, stop))) {
-                    goto fail;
-                }
-            }
-            start = stop + 1;
+    d->rows[ch >> 7][ch & 15] |= cast(uchar)(1u << ((ch >> 4) & 7));
+}
+
+String_Delimiters
+string_delimiters_from_traits(u16 traits)
+{
+    String_Delimiters d;
+
+    memset(&d, 0, sizeof(d));
+    for (size_t ch = 0; ch < count_of(ASCII_CHAR_TRAITS); ch += 1) {
+        if (ASCII_CHAR_TRAITS[ch] & traits) {
+            internal_string_delimiters_set(&d, cast(uchar)ch);
         }
     }
+    return d;
+}
 
-    // Have a final substring?
-    if (start < s.len) {
-        if (!string_dynamic_append(&d, string_sub(s, start, s.len))) {
-fail:
-            string_dynamic_delete(&d);
-            return (String_Slice){NULL, 0};
+void
+string_delimiters_add(String_Delimiters *d, String chars)
+{
+    for (size_t i = 0; i < chars.len; i += 1) {
+        internal_string_delimiters_set(d, cast(uchar)chars.data[i]);
+    }
+}
+
+bool
+string_delimiters_has(const String_Delimiters *d, char ch)
+{
+    uchar i = cast(uchar)ch;
+    return (d->rows[i >> 7][i & 15] >> ((i >> 4) & 7)) & 1;
+}
+
+#if defined(UTILS_STRINGS_SHUFFLE_WIDTH)
+
+/** @brief Bit `i` is set if `data[i]` is in `d`, for the next
+ *  `UTILS_STRINGS_SHUFFLE_WIDTH` bytes.
+ *
+ * @note
+ *  The low nibble of each byte selects an entry of both rows, and the high
+ *  nibble selects the one bit of either entry that stands for that byte.
+ *  The shuffles only look at the low 4 bits of each index, and yield zero
+ *  if its top bit is set, which is how `bit_lo` and `bit_hi` each only
+ *  cover half of the high nibbles.
+ */
+static u32
+internal_string_delimiter_mask_simd(const char *data, const String_Delimiters *d)
+{
+#if UTILS_STRINGS_SHUFFLE_WIDTH == 32
+    __m256i v, lo, hi, row_lo, row_hi, bit_lo, bit_hi, m;
+
+    v  = _mm256_loadu_si256(cast(const __m256i *)data);
+    lo = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+    hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+
+    // High nibbles 0-7 index `bit_lo`, and 8-15 are out of its range.
+    bit_lo = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    bit_hi = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128,
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    row_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(const __m128i *)d->rows[0]));
+    row_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(const __m128i *)d->rows[1]));
+
+    m = _mm256_or_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(row_lo, lo), _mm256_shuffle_epi8(bit_lo, hi)),
+        _mm256_and_si256(_mm256_shuffle_epi8(row_hi, lo), _mm256_shuffle_epi8(bit_hi, hi)));
+    return ~cast(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(m, _mm256_setzero_si256()));
+#else
+    __m128i v, lo, hi, row_lo, row_hi, bit_lo, bit_hi, m;
+
+    v  = _mm_loadu_si128(cast(const __m128i *)data);
+    lo = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+    hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f));
+
+    bit_lo = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    bit_hi = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    row_lo = _mm_loadu_si128(cast(const __m128i *)d->rows[0]);
+    row_hi = _mm_loadu_si128(cast(const __m128i *)d->rows[1]);
+
+    m = _mm_or_si128(
+        _mm_and_si128(_mm_shuffle_epi8(row_lo, lo), _mm_shuffle_epi8(bit_lo, hi)),
+        _mm_and_si128(_mm_shuffle_epi8(row_hi, lo), _mm_shuffle_epi8(bit_hi, hi)));
+    return ~cast(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128())) & 0xffff;
+#endif // UTILS_STRINGS_SHUFFLE_WIDTH
+}
+
+#endif // UTILS_STRINGS_SHUFFLE_WIDTH
+
+
+/** @brief Same as `internal_string_space_mask`, but for the bytes in `d`. */
+static u64
+internal_string_delimiter_mask(const char *data, size_t n, const String_Delimiters *d)
+{
+    u64 mask = 0;
+    size_t i = 0;
+
+    assert(n <= UTILS_STRINGS_BLOCK_SIZE);
+#if defined(UTILS_STRINGS_SHUFFLE_WIDTH)
+    for (; i + UTILS_STRINGS_SHUFFLE_WIDTH <= n; i += UTILS_STRINGS_SHUFFLE_WIDTH) {
+        mask |= cast(u64)internal_string_delimiter_mask_simd(data + i, d) << i;
+    }
+#endif // UTILS_STRINGS_SHUFFLE_WIDTH
+
+    for (; i < n; i += 1) {
+        mask |= cast(u64)string_delimiters_has(d, data[i]) << i;
+    }
+
+    if (n < UTILS_STRINGS_BLOCK_SIZE) {
+        mask |= U64_MAX << n;
+    }
+    return mask;
+}
+
+// === }}} =====================================================================
+
+// WHITESPACE SCANNING ===================================================== {{{
+
+#if UTILS_STRINGS_SIMD_WIDTH == 8
+
+/** @brief The high bit of each byte of the result is set if that byte of `v`
+ *  is zero. Unlike the usual `(v - 0x01..) & ~v & 0x80..`, no borrow can leak
+ *  into the next byte, so every bit is exact. */
+static u64
+internal_string_swar_zero_bytes(u64 v)
+{
+    const u64 low7 = 0x7f7f7f7f7f7f7f7fu;
+    return ~(((v & low7) + low7) | v | low7);
+}
+
+#endif // UTILS_STRINGS_SIMD_WIDTH
+
+#if defined(UTILS_STRINGS_SIMD_WIDTH)
+
+/** @brief Bit `i` is set if `data[i]` is whitespace, as in `char_is_space`,
+ *  for the next `UTILS_STRINGS_SIMD_WIDTH` bytes. */
+static u32
+internal_string_space_mask_simd(const char *data)
+{
+#if UTILS_STRINGS_SIMD_WIDTH == 32
+    __m256i v, t, m;
+
+    // '\t' through '\r' are contiguous, so test them as an unsigned range:
+    // `ch - '\t' <= '\r' - '\t'` if and only if the minimum is unchanged.
+    v = _mm256_loadu_si256(cast(const __m256i *)data);
+    t = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+    m = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8('\r' - '\t')), t);
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+    return cast(u32)_mm256_movemask_epi8(m);
+#elif UTILS_STRINGS_SIMD_WIDTH == 16
+    __m128i v, t, m;
+
+    v = _mm_loadu_si128(cast(const __m128i *)data);
+    t = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    m = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('\r' - '\t')), t);
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    return cast(u32)_mm_movemask_epi8(m);
+#else
+    const u64 ones = 0x0101010101010101u;
+    u64 v, m;
+
+    memcpy(&v, data, sizeof(v));
+    m = internal_string_swar_zero_bytes(v ^ (ones * ' '))
+      | internal_string_swar_zero_bytes(v ^ (ones * '\t'))
+      | internal_string_swar_zero_bytes(v ^ (ones * '\n'))
+      | internal_string_swar_zero_bytes(v ^ (ones * '\v'))
+      | internal_string_swar_zero_bytes(v ^ (ones * '\f'))
+      | internal_string_swar_zero_bytes(v ^ (ones * '\r'));
+
+    // Gather the high bit of byte `i` into bit `i`.
+    return cast(u32)(((m >> 7) * 0x0102040810204080u) >> 56);
+#endif // UTILS_STRINGS_SIMD_WIDTH
+}
+
+#endif // UTILS_STRINGS_SIMD_WIDTH
+
+
+/** @brief Bit `i` is set if `data[i]` is whitespace, for the first `n` bytes
+ *  of `data`. The remaining bits, up to `UTILS_STRINGS_BLOCK_SIZE`, are set as
+ *  well so that the end of the string acts as a delimiter. */
+static u64
+internal_string_space_mask(const char *data, size_t n)
+{
+    u64 mask = 0;
+    size_t i = 0;
+
+    assert(n <= UTILS_STRINGS_BLOCK_SIZE);
+#if defined(UTILS_STRINGS_SIMD_WIDTH)
+    for (; i + UTILS_STRINGS_SIMD_WIDTH <= n; i += UTILS_STRINGS_SIMD_WIDTH) {
+        mask |= cast(u64)internal_string_space_mask_simd(data + i) << i;
+    }
+#endif // UTILS_STRINGS_SIMD_WIDTH
+
+    // Scalar fallback, also used for the tail that does not fill a vector.
+    for (; i < n; i += 1) {
+        mask |= cast(u64)char_is_space(data[i]) << i;
+    }
+
+    if (n < UTILS_STRINGS_BLOCK_SIZE) {
+        mask |= U64_MAX << n;
+    }
+    return mask;
+}
+
+static size_t
+internal_string_count_trailing_zeros(u64 x)
+{
+    assert(x != 0);
+#if defined(__GNUC__)
+    return cast(size_t)__builtin_ctzll(x);
+#else
+    size_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n += 1;
+    }
+    return n;
+#endif // __GNUC__
+}
+
+static size_t
+internal_string_count_ones(u64 x)
+{
+#if defined(__GNUC__)
+    return cast(size_t)__builtin_popcountll(x);
+#else
+    size_t n = 0;
+    for (; x != 0; x &= x - 1) {
+        n += 1;
+    }
+    return n;
+#endif // __GNUC__
+}
+
+
+/** @brief Number of substrings `string_split` would yield, without visiting
+ *  each of them: a substring starts at every non-whitespace byte right after
+ *  a whitespace byte (or the start of `s`). */
+static size_t
+internal_string_count_words(String s)
+{
+    size_t count = 0;
+    u64 carry    = 1;
+
+    for (size_t block = 0; block < s.len; block += UTILS_STRINGS_BLOCK_SIZE) {
+        size_t n = s.len - block;
+        u64 spaces;
+
+        if (n > UTILS_STRINGS_BLOCK_SIZE) {
+            n = UTILS_STRINGS_BLOCK_SIZE;
+        }
+        spaces = internal_string_space_mask(s.data + block, n);
+        count += internal_string_count_ones(~spaces & ((spaces << 1) | carry));
+        carry  = spaces >> (UTILS_STRINGS_BLOCK_SIZE - 1);
+    }
+    return count;
+}
+
+static size_t
+internal_string_find(String s, size_t start, bool space)
+{
+    for (size_t block = start; block < s.len; block += UTILS_STRINGS_BLOCK_SIZE) {
+        size_t n = s.len - block;
+        u64 bits;
+
+        if (n > UTILS_STRINGS_BLOCK_SIZE) {
+            n = UTILS_STRINGS_BLOCK_SIZE;
+        }
+
+        bits = internal_string_space_mask(s.data + block, n);
+        if (!space) {
+            bits = ~bits;
+        }
+        if (bits != 0) {
+            // Out of bounds bits only count as whitespace.
+            return block + internal_string_count_trailing_zeros(bits);
+        }
+    }
+    return s.len;
+}
+
+size_t
+string_find_space(String s, size_t start)
+{
+    return internal_string_find(s, start, /*space=*/true);
+}
+
+size_t
+string_find_non_space(String s, size_t start)
+{
+    return internal_string_find(s, start, /*space=*/false);
+}
+
+static void
+internal_string_split_load(String_Split_Iterator *it, size_t block)
+{
+    size_t n = it->s.len - block;
+    if (n > UTILS_STRINGS_BLOCK_SIZE) {
+        n = UTILS_STRINGS_BLOCK_SIZE;
+    }
+    it->block = block;
+    // Avoid offsetting `s.data` when it may be `NULL`.
+    if (n == 0) {
+        it->mask = U64_MAX;
+    } else if (it->delimiters == NULL) {
+        it->mask = internal_string_space_mask(it->s.data + block, n);
+    } else {
+        it->mask = internal_string_delimiter_mask(it->s.data + block, n, it->delimiters);
+    }
+}
+
+void
+string_split_iterator_init(String_Split_Iterator *it, String s)
+{
+    string_split_iterator_init_delimiters(it, s, NULL);
+}
+
+void
+string_split_iterator_init_delimiters(String_Split_Iterator *it,
+    String                   s,
+    const String_Delimiters *d)
+{
+    it->s          = s;
+    it->delimiters = d;
+    it->offset     = 0;
+    internal_string_split_load(it, 0);
+}
+
+
+/** @brief Index of the first delimiter (or non-delimiter) at or after
+ *  `it->offset`, reusing the classified block for as long as possible. */
+static size_t
+internal_string_split_scan(String_Split_Iterator *it, bool delimiter)
+{
+    for (;;) {
+        size_t shift = it->offset - it->block;
+        size_t next;
+
+        if (shift < UTILS_STRINGS_BLOCK_SIZE) {
+            u64 bits = (delimiter) ? it->mask : ~it->mask;
+
+            bits &= U64_MAX << shift;
+            if (bits != 0) {
+                return it->block + internal_string_count_trailing_zeros(bits);
+            }
+        }
+
+        next = it->block + UTILS_STRINGS_BLOCK_SIZE;
+        if (next >= it->s.len) {
+            return it->s.len;
         }
+        it->offset = next;
+        internal_string_split_load(it, next);
     }
+}
 
-    // Resize list to be exact
-    string_dynamic_resize(&d, d.len);
-    return (String_Slice){d.data, d.len};
+bool
+string_split_next(String_Split_Iterator *it, String *token)
+{
+    size_t start, stop;
+
+    start      = internal_string_split_scan(it, /*delimiter=*/false);
+    it->offset = start;
+    if (start >= it->s.len) {
+        return false;
+    }
+
+    stop       = internal_string_split_scan(it, /*delimiter=*/true);
+    it->offset = stop;
+    *token     = string_sub(it->s, start, stop);
+    return true;
+}
+
+// === }}} =====================================================================
+
+String_Slice
+string_split(String s, Allocator allocator)
+{
+    String_Split_Iterator it;
+    String_Slice list;
+    String token;
+    size_t count;
+
+    // Counting first is far cheaper than growing (and then shrinking) the
+    // list as we go.
+    count = internal_string_count_words(s);
+    if (count == 0) {
+        return (String_Slice){NULL, 0};
+    }
+
+    list.data = array_make_non_zeroed(String, count, allocator);
+    if (list.data == NULL) {
+        return (String_Slice){NULL, 0};
+    }
+    list.len = 0;
+
+    string_split_iterator_init(&it, s);
+    while (string_split_next(&it, &token)) {
+        list.data[list.len] = token;
+        list.len += 1;
+    }
+    return list;
 }
 
 String
@@ -121,7 +512,8 @@ string_dynamic_init(String_Dynamic *d, Allocator allocator)
 bool
 string_dynamic_resize(String_Dynamic *d, size_t n)
 {
-    String *tmp = array_resize(String, d->data, d->cap, n, d->allocator);
+    // Only `d->data[:d->len]` is ever read, so the new slots need not be zeroed.
+    String *tmp = array_resize_non_zeroed(String, d->data, d->cap, n, d->allocator);
     if (tmp == NULL) {
         return false;
     }
@@ -130,14 +522,37 @@ string_dynamic_resize(String_Dynamic *d, size_t n)
     return true;
 }
 
+/** @brief Same as `internal_string_builder_grow`, but for `String_Dynamic`. */
+static bool
+internal_string_dynamic_grow(String_Dynamic *d, size_t min_cap)
+{
+    size_t new_cap = (d->cap < 8) ? 8 : (d->cap * 2);
+
+    if (new_cap < min_cap) {
+        new_cap = min_cap;
+    }
+
+    if (d->data != NULL) {
+        if (mem_try_resize_in_place(d->data, sizeof(String) * d->cap,
+            sizeof(String) * new_cap, d->allocator))
+        {
+            d->cap = new_cap;
+            return true;
+        } else if (min_cap < new_cap && mem_try_resize_in_place(d->data,
+            sizeof(String) * d->cap, sizeof(String) * min_cap, d->allocator))
+        {
+            d->cap = min_cap;
+            return true;
+        }
+    }
+    return string_dynamic_resize(d, new_cap);
+}
+
 bool
 string_dynamic_append(String_Dynamic *d, String s)
 {
-    if (d->len + 1 > d->cap) {
-        size_t new_cap = (d->cap < 8) ? 8 : (d->cap * 2);
-        if (!string_dynamic_resize(d, new_cap)) {
-            return false;
-        }
+    if (d->len + 1 > d->cap && !internal_string_dynamic_grow(d, d->len + 1)) {
+        return false;
     }
     d->data[d->len] = s;
     d->len += 1;
@@ -169,26 +584,96 @@ string_builder_destroy(String_Builder *sb)
     array_delete(sb->data, sb->cap, sb->allocator);
 }
 
+/** @brief Grow `sb` to hold at least `min_cap` bytes. Prefers growing
+ *  in-place, even if only to exactly `min_cap`, over moving everything. */
+static bool
+internal_string_builder_grow_loc(String_Builder *sb, size_t min_cap,
+    const char *location)
+{
+    size_t new_cap = (sb->cap < 8) ? 8 : UTILS_STRING_BUILDER_GROW(sb->cap);
+    char *tmp;
+
+    if (new_cap < min_cap) {
+        new_cap = min_cap;
+    }
+
+    if (sb->data != NULL) {
+        if (mem_try_resize_in_place_loc(sb->data, sb->cap, new_cap, sb->allocator,
+            location))
+        {
+            sb->cap = new_cap;
+            return true;
+        } else if (min_cap < new_cap && mem_try_resize_in_place_loc(sb->data,
+            sb->cap, min_cap, sb->allocator, location))
+        {
+            sb->cap = min_cap;
+            return true;
+        }
+    }
+
+    tmp = array_resize_non_zeroed_loc(char, sb->data, sb->cap, new_cap,
+        sb->allocator, location);
+    if (tmp == NULL) {
+        return false;
+    }
+    sb->data = tmp;
+    sb->cap  = new_cap;
+    return true;
+}
+
+#define internal_string_builder_grow(sb, min_cap)                              \
+    internal_string_builder_grow_loc(sb, min_cap, FILE_LINE_STRING)
+
+bool
+string_builder_reserve_loc(String_Builder *sb, size_t cap, const char *location)
+{
+    char *tmp;
+
+    if (cap <= sb->cap) {
+        return true;
+    }
+
+    if (sb->data != NULL
+        && mem_try_resize_in_place_loc(sb->data, sb->cap, cap, sb->allocator,
+            location))
+    {
+        sb->cap = cap;
+        return true;
+    }
+
+    tmp = array_resize_non_zeroed_loc(char, sb->data, sb->cap, cap, sb->allocator,
+        location);
+    if (tmp == NULL) {
+        return false;
+    }
+    sb->data = tmp;
+    sb->cap  = cap;
+    return true;
+}
+
+char *
+string_builder_extend(String_Builder *sb, size_t n)
+{
+    size_t new_len = sb->len + n;
+    char *res;
+
+    assert(n > 0);
+    if (new_len > sb->cap && !internal_string_builder_grow(sb, new_len)) {
+        return NULL;
+    }
+    res     = &sb->data[sb->len];
+    sb->len = new_len;
+    return res;
+}
+
 bool
 string_write_string(String_Builder *sb, const char *data, size_t len)
 {
     size_t new_len = sb->len + len;
 
     // Ensure append is within bounds.
-    if (new_len > sb->cap) {
-        size_t new_cap = sb->cap * 2;
-        if (new_cap < 8) {
-            new_cap = 8;
-        } else if (new_len > new_cap) {
-            new_cap = new_len;
-        }
-
-        char *tmp = array_resize(char, sb->data, sb->cap, new_cap, sb->allocator);
-        if (tmp == NULL) {
-            return false;
-        }
-        sb->data = tmp;
-        sb->cap  = new_cap;
+    if (new_len > sb->cap && !internal_string_builder_grow(sb, new_len)) {
+        return false;
     }
     memcpy(&sb->data[sb->len], data, len);
     sb->len = new_len;
@@ -199,14 +684,8 @@ bool
 string_write_char(String_Builder *sb, char c)
 {
     // Ensure append is within bounds.
-    if (sb->len + 1 > sb->cap) {
-        size_t new_cap = (sb->cap < 8) ? 8 : (sb->cap * 2);
-        char *tmp = array_resize(char, sb->data, sb->cap, new_cap, sb->allocator);
-        if (tmp == NULL) {
-            return false;
-        }
-        sb->data = tmp;
-        sb->cap  = new_cap;
+    if (sb->len + 1 > sb->cap && !internal_string_builder_grow(sb, sb->len + 1)) {
+        return false;
     }
 
     sb->data[sb->len] = c;
@@ -214,6 +693,123 @@ string_write_char(String_Builder *sb, char c)
     return true;
 }
 
+bool
+string_write_repeat(String_Builder *sb, char c, size_t n)
+{
+    char *out;
+
+    if (n == 0) {
+        return true;
+    }
+    out = string_builder_extend(sb, n);
+    if (out == NULL) {
+        return false;
+    }
+    memset(out, c, n);
+    return true;
+}
+
+static size_t
+internal_string_uint_length(u64 value, uint base)
+{
+    size_t n = 1;
+    for (u64 rest = value / base; rest != 0; rest /= base) {
+        n += 1;
+    }
+    return n;
+}
+
+static void
+internal_string_format_uint(char *buf, size_t n, u64 value, uint base)
+{
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    // Least significant digit first; once `value` runs out, the rest are
+    // leading zeroes.
+    while (n > 0) {
+        n -= 1;
+        buf[n] = digits[value % base];
+        value /= base;
+    }
+}
+
+// Dividing by a constant base compiles down to a multiplication, which is
+// several times faster than a division. Hence the special cases below.
+
+size_t
+string_uint_length(u64 value, uint base)
+{
+    assert(2 <= base && base <= 36);
+    switch (base) {
+    case 10: return internal_string_uint_length(value, 10);
+    case 16: return internal_string_uint_length(value, 16);
+    }
+    return internal_string_uint_length(value, base);
+}
+
+void
+string_format_uint(char *buf, size_t n, u64 value, uint base)
+{
+    assert(2 <= base && base <= 36);
+    switch (base) {
+    case 10: internal_string_format_uint(buf, n, value, 10); break;
+    case 16: internal_string_format_uint(buf, n, value, 16); break;
+    default: internal_string_format_uint(buf, n, value, base); break;
+    }
+}
+
+bool
+string_write_uint(String_Builder *sb, u64 value, uint base, size_t min_digits)
+{
+    size_t n = string_uint_length(value, base);
+    char *out;
+
+    if (n < min_digits) {
+        n = min_digits;
+    }
+
+    out = string_builder_extend(sb, n);
+    if (out == NULL) {
+        return false;
+    }
+    string_format_uint(out, n, value, base);
+    return true;
+}
+
+bool
+string_write_int(String_Builder *sb, i64 value, uint base, size_t min_digits)
+{
+    u64 magnitude = cast(u64)value;
+
+    if (value < 0) {
+        if (!string_write_char(sb, '-')) {
+            return false;
+        }
+        // Well-defined even for `I64_MIN`.
+        magnitude = 0 - magnitude;
+    }
+    return string_write_uint(sb, magnitude, base, min_digits);
+}
+
+bool
+string_write_builder(String_Builder *sb, const String_Builder *src)
+{
+    size_t n = src->len;
+    char *out;
+
+    if (n == 0) {
+        return true;
+    }
+
+    // May move `src->data` if `src == sb`, so only read it afterwards.
+    out = string_builder_extend(sb, n);
+    if (out == NULL) {
+        return false;
+    }
+    memcpy(out, src->data, n);
+    return true;
+}
+
 char
 string_pop_char(String_Builder *sb)
 {
@@ -4,6 +4,8 @@
 #include <projects.h>
 #include <mem/allocator.h>
 
+#include "chars.h"
+
 typedef struct String String;
 struct String {
     const char *data;
@@ -34,6 +36,47 @@ struct String_Dynamic {
     Allocator allocator;
 };
 
+/** @brief A set of bytes to split on, for `string_split_iterator_init_delimiters`. */
+typedef struct String_Delimiters String_Delimiters;
+struct String_Delimiters {
+    // Bit `(ch >> 4) % 8` of `rows[ch >> 7][ch & 15]` is set if byte `ch` is
+    // a delimiter. Indexing by the low nibble lets SSSE3 and AVX2 look up 16
+    // or 32 bytes at once with a byte shuffle.
+    uchar rows[2][16];
+};
+
+/**
+ * @brief Yields the substrings of `s` between delimiters one at a time,
+ *  without allocating. Delimiters are whitespace unless given otherwise.
+ *
+ * @note
+ *  Delimiters are classified 64 bytes at a time into `mask`, using SSE2,
+ *  SSSE3 or AVX2 when available, so that token boundaries are found by
+ *  scanning bits rather than bytes.
+ */
+typedef struct String_Split_Iterator String_Split_Iterator;
+struct String_Split_Iterator {
+    String s;
+
+    // `NULL` to split on whitespace, as in `char_is_space`.
+    const String_Delimiters *delimiters;
+
+    // Offset of the next byte to look at.
+    size_t offset;
+
+    // Offset of the block of (up to) 64 bytes containing `offset`, and its
+    // bitmask: bit `i` is set if `s.data[block + i]` is a delimiter or out of
+    // bounds.
+    size_t block;
+    u64    mask;
+};
+
+// Capacity a full `String_Builder` grows to, from its current `cap`. Must be
+// greater than `cap` for any `cap >= 8`.
+#ifndef UTILS_STRING_BUILDER_GROW
+#define UTILS_STRING_BUILDER_GROW(cap)  ((cap) * 2)
+#endif // UTILS_STRING_BUILDER_GROW
+
 typedef struct String_Builder String_Builder;
 struct String_Builder {
     char     *data;
@@ -63,6 +106,55 @@ char_is_space(char ch);
 String
 string_sub(String s, size_t start, size_t stop);
 
+
+/** @brief Index of the first whitespace in `s` at or after `start`, or
+ *  `s.len` if there is none. */
+size_t
+string_find_space(String s, size_t start);
+
+
+/** @brief Index of the first non-whitespace in `s` at or after `start`, or
+ *  `s.len` if there is none. */
+size_t
+string_find_non_space(String s, size_t start);
+
+/** @brief Split `s` on whitespace. */
+void
+string_split_iterator_init(String_Split_Iterator *it, String s);
+
+
+/** @brief Split `s` on any byte in `d`, which must outlive `it`. */
+void
+string_split_iterator_init_delimiters(String_Split_Iterator *it,
+    String                   s,
+    const String_Delimiters *d);
+
+
+/** @brief Write the next substring of `it->s` that contains no delimiters
+ *  to `token`.
+ *
+ * @return `false` once there are no more substrings, leaving `token` as is.
+ */
+bool
+string_split_next(String_Split_Iterator *it, String *token);
+
+
+/** @brief Every byte of the ASCII range that has any of `traits`, e.g.
+ *  `CHAR_SPACE | CHAR_PUNCT`. */
+String_Delimiters
+string_delimiters_from_traits(u16 traits);
+
+
+/** @brief Add each byte in `chars` to `d`. */
+void
+string_delimiters_add(String_Delimiters *d, String chars);
+
+bool
+string_delimiters_has(const String_Delimiters *d, char ch);
+
+
+/** @brief Collect every substring yielded by a `String_Split_Iterator` into
+ *  a single exactly-sized allocation. */
 String_Slice
 string_split(String s, Allocator allocator);
 
@@ -87,6 +179,27 @@ string_builder_init(String_Builder *sb, Allocator allocator);
 void
 string_builder_destroy(String_Builder *sb);
 
+
+/** @brief Ensure `sb` can hold `cap` bytes in total without growing. Unlike
+ *  growth from writes, `sb->cap` becomes exactly `cap` if it was smaller.
+ *  The request is attributed to `location`, see `string_builder_reserve`. */
+bool
+string_builder_reserve_loc(String_Builder *sb, size_t cap, const char *location);
+
+#define string_builder_reserve(sb, cap)                                        \
+    string_builder_reserve_loc(sb, cap, FILE_LINE_STRING)
+
+
+/** @brief Append `n` uninitialized bytes to `sb`, to be filled in directly
+ *  by the caller, e.g. right to left.
+ *
+ * @param n  Must be nonzero.
+ *
+ * @return The first of the new bytes, or `NULL` if out of memory.
+ */
+char *
+string_builder_extend(String_Builder *sb, size_t n);
+
 #define string_write_literal(sb, s) string_write_string(sb, s, sizeof(s) - 1)
 
 bool
@@ -95,6 +208,45 @@ string_write_string(String_Builder *sb, const char *data, size_t len);
 bool
 string_write_char(String_Builder *sb, char c);
 
+
+/** @brief Write `c` `n` times. */
+bool
+string_write_repeat(String_Builder *sb, char c, size_t n);
+
+
+/** @brief Number of base-`base` digits in `value`, which is at least 1.
+ *
+ * @param base  In the range `[2, 36]`.
+ */
+size_t
+string_uint_length(u64 value, uint base);
+
+
+/** @brief Write the `n` least significant base-`base` digits of `value` to
+ *  `buf[:n]`, padding with leading zeroes as needed. */
+void
+string_format_uint(char *buf, size_t n, u64 value, uint base);
+
+
+/** @brief Write `value` in `base`, using lowercase letters past 9 and no
+ *  prefix, padded with leading zeroes to at least `min_digits` digits.
+ *
+ * @param base  In the range `[2, 36]`.
+ */
+bool
+string_write_uint(String_Builder *sb, u64 value, uint base, size_t min_digits);
+
+
+/** @brief Same as `string_write_uint`, but with a leading `-` if `value` is
+ *  negative. The sign does not count towards `min_digits`. */
+bool
+string_write_int(String_Builder *sb, i64 value, uint base, size_t min_digits);
+
+
+/** @brief Write the contents of `src`, which may be `sb` itself. */
+bool
+string_write_builder(String_Builder *sb, const String_Builder *src);
+
 char
 string_pop_char(String_Builder *sb);
 
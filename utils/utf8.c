@@ -0,0 +1,446 @@
+#include <string.h> // memcpy, memset
+
+#include "utf8.h"
+
+// Define to validate with the portable code even when SSSE3 or AVX2 is
+// available, e.g. to compare against them.
+// #define UTILS_UTF8_NO_SIMD
+
+// The vector kernels need a byte shuffle, which plain SSE2 lacks.
+#if !defined(UTILS_UTF8_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h> // _mm256_*
+#define UTILS_UTF8_SIMD_WIDTH   32
+#elif !defined(UTILS_UTF8_NO_SIMD) && defined(__SSSE3__)
+#include <tmmintrin.h> // _mm_*
+#define UTILS_UTF8_SIMD_WIDTH   16
+#endif // UTILS_UTF8_NO_SIMD
+
+#define UTF8_ASCII_MASK_U64 0x8080808080808080u
+#define UTF8_ONES_U64       0x0101010101010101u
+
+static bool
+internal_utf8_is_continuation(u8 byte)
+{
+    return (byte & 0xc0) == 0x80;
+}
+
+
+/** @brief Length of the valid sequence at the start of `p[:n]`, per Table 3-7
+ *  of the Unicode Standard, or 0 if there is none.
+ *
+ * @param n  Must be nonzero.
+ */
+static size_t
+internal_utf8_sequence_length(const u8 *p, size_t n)
+{
+    u8 lead = p[0];
+    u8 lo   = 0x80;
+    u8 hi   = 0xbf;
+    size_t len;
+
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead < 0xc2) {
+        // Stray continuation byte, or an overlong 2-byte form.
+        return 0;
+    } else if (lead < 0xe0) {
+        len = 2;
+    } else if (lead < 0xf0) {
+        len = 3;
+        if (lead == 0xe0) {
+            // Overlong.
+            lo = 0xa0;
+        } else if (lead == 0xed) {
+            // Surrogates.
+            hi = 0x9f;
+        }
+    } else if (lead < 0xf5) {
+        len = 4;
+        if (lead == 0xf0) {
+            // Overlong.
+            lo = 0x90;
+        } else if (lead == 0xf4) {
+            // Past U+10FFFF.
+            hi = 0x8f;
+        }
+    } else {
+        return 0;
+    }
+
+    if (n < len || p[1] < lo || hi < p[1]) {
+        return 0;
+    }
+    for (size_t i = 2; i < len; i += 1) {
+        if (!internal_utf8_is_continuation(p[i])) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+static size_t
+internal_utf8_find_invalid_scalar(String s, size_t i)
+{
+    const u8 *p = cast(const u8 *)s.data;
+
+    while (i < s.len) {
+        size_t len;
+
+        // Skip runs of ASCII 8 bytes at a time.
+        if (s.len - i >= sizeof(u64)) {
+            u64 v;
+            memcpy(&v, p + i, sizeof(v));
+            if ((v & UTF8_ASCII_MASK_U64) == 0) {
+                i += sizeof(v);
+                continue;
+            }
+        }
+
+        len = internal_utf8_sequence_length(p + i, s.len - i);
+        if (len == 0) {
+            return i;
+        }
+        i += len;
+    }
+    return s.len;
+}
+
+#if defined(UTILS_UTF8_SIMD_WIDTH)
+
+// https://arxiv.org/abs/2010.03090 (Keiser & Lemire, "Validating UTF-8 In
+// Less Than One Instruction Per Byte"). Each byte is checked against the one
+// to three bytes before it. The high and low nibble of the previous byte and
+// the high nibble of the current one each look up the set of errors their
+// pair could be part of; a pair is wrong if all three lookups agree.
+
+#if UTILS_UTF8_SIMD_WIDTH == 32
+typedef __m256i Utf8_Vector;
+
+#define UTF8_VECTOR_LOAD(p)     _mm256_loadu_si256(cast(const __m256i *)(p))
+#define UTF8_VECTOR_SPLAT(b)    _mm256_set1_epi8(cast(char)(b))
+#define UTF8_VECTOR_ZERO()      _mm256_setzero_si256()
+#define UTF8_VECTOR_AND         _mm256_and_si256
+#define UTF8_VECTOR_OR          _mm256_or_si256
+#define UTF8_VECTOR_XOR         _mm256_xor_si256
+#define UTF8_VECTOR_SUB_SAT     _mm256_subs_epu8
+#define UTF8_VECTOR_CMPGT       _mm256_cmpgt_epi8
+#define UTF8_VECTOR_SHUFFLE     _mm256_shuffle_epi8
+#define UTF8_VECTOR_SHR4(v)     _mm256_srli_epi16(v, 4)
+#define UTF8_VECTOR_MASK(v)     cast(u32)_mm256_movemask_epi8(v)
+#define UTF8_VECTOR_IS_ZERO(v)  _mm256_testz_si256(v, v)
+
+// The same 16 entries in both lanes, as the shuffle works per lane.
+#define UTF8_VECTOR_TABLE(t)                                                   \
+    _mm256_broadcastsi128_si256(_mm_loadu_si128(cast(const __m128i *)(t)))
+
+// `v` shifted up by `n` bytes, with the last `n` bytes of `prev` shifted in.
+#define UTF8_VECTOR_PREV(v, prev, n)                                           \
+    _mm256_alignr_epi8(v, _mm256_permute2x128_si256(prev, v, 0x21), 16 - (n))
+
+#else // UTILS_UTF8_SIMD_WIDTH == 16
+typedef __m128i Utf8_Vector;
+
+#define UTF8_VECTOR_LOAD(p)     _mm_loadu_si128(cast(const __m128i *)(p))
+#define UTF8_VECTOR_SPLAT(b)    _mm_set1_epi8(cast(char)(b))
+#define UTF8_VECTOR_ZERO()      _mm_setzero_si128()
+#define UTF8_VECTOR_AND         _mm_and_si128
+#define UTF8_VECTOR_OR          _mm_or_si128
+#define UTF8_VECTOR_XOR         _mm_xor_si128
+#define UTF8_VECTOR_SUB_SAT     _mm_subs_epu8
+#define UTF8_VECTOR_CMPGT       _mm_cmpgt_epi8
+#define UTF8_VECTOR_SHUFFLE     _mm_shuffle_epi8
+#define UTF8_VECTOR_SHR4(v)     _mm_srli_epi16(v, 4)
+#define UTF8_VECTOR_MASK(v)     cast(u32)_mm_movemask_epi8(v)
+#define UTF8_VECTOR_IS_ZERO(v)  (UTF8_VECTOR_MASK(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xffff)
+#define UTF8_VECTOR_TABLE(t)    _mm_loadu_si128(cast(const __m128i *)(t))
+#define UTF8_VECTOR_PREV(v, prev, n)    _mm_alignr_epi8(v, prev, 16 - (n))
+
+#endif // UTILS_UTF8_SIMD_WIDTH
+
+// Errors a pair of bytes can be part of. Both bytes are given as bit
+// patterns, previous byte first.
+enum {
+    UTF8_TOO_SHORT      = 1 << 0, // 11______ 0_______, 11______ 11______
+    UTF8_TOO_LONG       = 1 << 1, // 0_______ 10______
+    UTF8_OVERLONG_3     = 1 << 2, // 11100000 100_____
+    UTF8_TOO_LARGE      = 1 << 3, // 11110100 1001____, 11110100 101_____,
+                                  // 11110101 1001____, ... 11111___ 1_______
+    UTF8_SURROGATE      = 1 << 4, // 11101101 101_____
+    UTF8_OVERLONG_2     = 1 << 5, // 1100000_ 10______
+    UTF8_TOO_LARGE_1000 = 1 << 6, // 11110101 1000____, ... 11111___ 1000____
+    UTF8_OVERLONG_4     = 1 << 6, // 11110000 1000____
+    UTF8_TWO_CONTS      = 1 << 7, // 10______ 10______
+
+    // Possible whatever the low nibble of the previous byte is.
+    UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS,
+};
+
+// Indexed by the high nibble of the previous byte.
+static const u8
+UTF8_BYTE_1_HIGH[16] = {
+    // 0_______: ASCII
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    // 10______: continuation
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    // 1100____, 1101____: 2-byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    // 1110____: 3-byte lead
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    // 1111____: 4-byte lead, or worse
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+};
+
+// Indexed by the low nibble of the previous byte.
+static const u8
+UTF8_BYTE_1_LOW[16] = {
+    // ____0000
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    // ____0001
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    // ____001_
+    UTF8_CARRY,
+    UTF8_CARRY,
+    // ____0100
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    // ____0101 through ____1100
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    // ____1101
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    // ____111_
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+};
+
+// Indexed by the high nibble of the current byte.
+static const u8
+UTF8_BYTE_2_HIGH[16] = {
+    // 0_______: ASCII
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    // 1000____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3
+        | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    // 1001____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3
+        | UTF8_TOO_LARGE,
+    // 101_____
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE
+        | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE
+        | UTF8_TOO_LARGE,
+    // 11______: lead
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+};
+
+
+/** @brief Validate `s` a vector at a time, as far as it fills whole vectors.
+ *
+ * @return The start of the first vector with an error, or the end of the
+ *  last whole vector. Every sequence that ends before it is valid.
+ */
+static size_t
+internal_utf8_validate_simd(String s)
+{
+    const u8 *p = cast(const u8 *)s.data;
+    u8 max_tail[UTILS_UTF8_SIMD_WIDTH];
+    Utf8_Vector byte_1_high, byte_1_low, byte_2_high, low_nibble, tail;
+    Utf8_Vector prev_input, prev_incomplete;
+    size_t i = 0;
+
+    // Bytes of a vector greater than these start a sequence that does not
+    // end in it: the last 3 must be less than a 4-, 3- and 2-byte lead.
+    memset(max_tail, 0xff, sizeof(max_tail) - 3);
+    max_tail[sizeof(max_tail) - 3] = 0xf0 - 1;
+    max_tail[sizeof(max_tail) - 2] = 0xe0 - 1;
+    max_tail[sizeof(max_tail) - 1] = 0xc0 - 1;
+
+    byte_1_high     = UTF8_VECTOR_TABLE(UTF8_BYTE_1_HIGH);
+    byte_1_low      = UTF8_VECTOR_TABLE(UTF8_BYTE_1_LOW);
+    byte_2_high     = UTF8_VECTOR_TABLE(UTF8_BYTE_2_HIGH);
+    low_nibble      = UTF8_VECTOR_SPLAT(0x0f);
+    tail            = UTF8_VECTOR_LOAD(max_tail);
+    prev_input      = UTF8_VECTOR_ZERO();
+    prev_incomplete = UTF8_VECTOR_ZERO();
+
+    for (; i + UTILS_UTF8_SIMD_WIDTH <= s.len; i += UTILS_UTF8_SIMD_WIDTH) {
+        Utf8_Vector input, prev1, prev2, prev3, special, must_continue;
+
+        input = UTF8_VECTOR_LOAD(p + i);
+        if (UTF8_VECTOR_MASK(input) == 0) {
+            // All ASCII, so only a sequence left unfinished can be wrong.
+            if (!UTF8_VECTOR_IS_ZERO(prev_incomplete)) {
+                return i;
+            }
+            prev_input = input;
+            continue;
+        }
+
+        prev1   = UTF8_VECTOR_PREV(input, prev_input, 1);
+        special = UTF8_VECTOR_AND(
+            UTF8_VECTOR_AND(
+                UTF8_VECTOR_SHUFFLE(byte_1_high,
+                    UTF8_VECTOR_AND(UTF8_VECTOR_SHR4(prev1), low_nibble)),
+                UTF8_VECTOR_SHUFFLE(byte_1_low,
+                    UTF8_VECTOR_AND(prev1, low_nibble))),
+            UTF8_VECTOR_SHUFFLE(byte_2_high,
+                UTF8_VECTOR_AND(UTF8_VECTOR_SHR4(input), low_nibble)));
+
+        // A byte 2 or 3 places after a 3- or 4-byte lead must continue it.
+        // The lookups above already flag any continuation right after one
+        // (`TWO_CONTS`), so the two must cancel out exactly.
+        prev2 = UTF8_VECTOR_PREV(input, prev_input, 2);
+        prev3 = UTF8_VECTOR_PREV(input, prev_input, 3);
+        must_continue = UTF8_VECTOR_AND(
+            UTF8_VECTOR_OR(
+                UTF8_VECTOR_SUB_SAT(prev2, UTF8_VECTOR_SPLAT(0xe0 - 0x80)),
+                UTF8_VECTOR_SUB_SAT(prev3, UTF8_VECTOR_SPLAT(0xf0 - 0x80))),
+            UTF8_VECTOR_SPLAT(0x80));
+        if (!UTF8_VECTOR_IS_ZERO(UTF8_VECTOR_XOR(must_continue, special))) {
+            return i;
+        }
+
+        prev_incomplete = UTF8_VECTOR_SUB_SAT(input, tail);
+        prev_input      = input;
+    }
+    return i;
+}
+
+static size_t
+internal_utf8_count_ones(u32 x)
+{
+#if defined(__GNUC__)
+    return cast(size_t)__builtin_popcount(x);
+#else
+    size_t n = 0;
+    for (; x != 0; x &= x - 1) {
+        n += 1;
+    }
+    return n;
+#endif // __GNUC__
+}
+
+#endif // UTILS_UTF8_SIMD_WIDTH
+
+size_t
+utf8_find_invalid(String s)
+{
+    size_t i = 0;
+
+#if defined(UTILS_UTF8_SIMD_WIDTH)
+    size_t start;
+
+    // Back up to the start of the sequence that `i` falls in, if any; the
+    // scalar code finds the exact offset of the error, and handles the tail.
+    i     = internal_utf8_validate_simd(s);
+    start = (i < 3) ? 0 : i - 3;
+    while (start < i && internal_utf8_is_continuation(cast(u8)s.data[start])) {
+        start += 1;
+    }
+    i = start;
+#endif // UTILS_UTF8_SIMD_WIDTH
+
+    return internal_utf8_find_invalid_scalar(s, i);
+}
+
+bool
+utf8_is_valid(String s)
+{
+    return utf8_find_invalid(s) == s.len;
+}
+
+size_t
+utf8_incomplete_suffix(String s)
+{
+    const u8 *p = cast(const u8 *)s.data;
+
+    // Walk back over continuation bytes to the byte that leads them.
+    for (size_t n = 1; n < UTF8_MAX_RUNE_SIZE && n <= s.len; n += 1) {
+        u8 lead = p[s.len - n];
+        size_t need;
+
+        if (internal_utf8_is_continuation(lead)) {
+            continue;
+        }
+        need = (lead >= 0xf0) ? 4 : (lead >= 0xe0) ? 3 : (lead >= 0xc0) ? 2 : 1;
+        return (need > n) ? n : 0;
+    }
+    return 0;
+}
+
+size_t
+utf8_count(String s)
+{
+    const u8 *p  = cast(const u8 *)s.data;
+    size_t count = 0;
+    size_t i     = 0;
+
+#if defined(UTILS_UTF8_SIMD_WIDTH)
+    // Continuation bytes are exactly those less than -64 as signed bytes.
+    for (; i + UTILS_UTF8_SIMD_WIDTH <= s.len; i += UTILS_UTF8_SIMD_WIDTH) {
+        Utf8_Vector v = UTF8_VECTOR_LOAD(p + i);
+        Utf8_Vector m = UTF8_VECTOR_CMPGT(v, UTF8_VECTOR_SPLAT(0xbf));
+        count += internal_utf8_count_ones(UTF8_VECTOR_MASK(m));
+    }
+#endif // UTILS_UTF8_SIMD_WIDTH
+
+    for (; i + sizeof(u64) <= s.len; i += sizeof(u64)) {
+        u64 v, starts;
+
+        // Bit 0 of each byte is set unless its top bits are `10`. Then sum
+        // all 8 bytes into the top one; none can carry.
+        memcpy(&v, p + i, sizeof(v));
+        starts = ((~v >> 7) | (v >> 6)) & UTF8_ONES_U64;
+        count += cast(size_t)((starts * UTF8_ONES_U64) >> 56);
+    }
+
+    for (; i < s.len; i += 1) {
+        count += !internal_utf8_is_continuation(p[i]);
+    }
+    return count;
+}
+
+bool
+utf8_next_rune(String s, size_t *cursor, u32 *rune)
+{
+    const u8 *p;
+    size_t i = *cursor;
+    size_t len;
+
+    if (i >= s.len) {
+        return false;
+    }
+
+    p   = cast(const u8 *)s.data + i;
+    len = internal_utf8_sequence_length(p, s.len - i);
+    switch (len) {
+    case 0:
+        *rune = UTF8_RUNE_ERROR;
+        len   = 1;
+        break;
+    case 1:
+        *rune = p[0];
+        break;
+    case 2:
+        *rune = (cast(u32)(p[0] & 0x1f) << 6) | cast(u32)(p[1] & 0x3f);
+        break;
+    case 3:
+        *rune = (cast(u32)(p[0] & 0x0f) << 12) | (cast(u32)(p[1] & 0x3f) << 6)
+            | cast(u32)(p[2] & 0x3f);
+        break;
+    default:
+        *rune = (cast(u32)(p[0] & 0x07) << 18) | (cast(u32)(p[1] & 0x3f) << 12)
+            | (cast(u32)(p[2] & 0x3f) << 6) | cast(u32)(p[3] & 0x3f);
+        break;
+    }
+    *cursor = i + len;
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef UTILS_UTF8_H
+#define UTILS_UTF8_H
+
+#include "strings.h"
+
+// Decoded in place of bytes that do not form a valid sequence.
+#define UTF8_RUNE_ERROR     0xfffd
+
+// Longest encoding of a single codepoint, in bytes.
+#define UTF8_MAX_RUNE_SIZE  4
+
+/** @brief Offset of the first byte of `s` that does not start or continue a
+ *  valid UTF-8 sequence: overlong forms, surrogates, codepoints past
+ *  U+10FFFF and truncated sequences are all invalid.
+ *
+ * @return `s.len` if all of `s` is valid.
+ */
+size_t
+utf8_find_invalid(String s);
+
+bool
+utf8_is_valid(String s);
+
+
+/** @brief Number of bytes at the end of `s` that start a sequence but stop
+ *  short of its length, e.g. because `s` is one chunk of a longer input.
+ *  Carry them over to the next chunk before validating either.
+ *
+ * @return At most `UTF8_MAX_RUNE_SIZE - 1`.
+ */
+size_t
+utf8_incomplete_suffix(String s);
+
+
+/** @brief Number of codepoints in `s`, i.e. the number of bytes that do not
+ *  continue a sequence. Only meaningful if `s` is valid; see
+ *  `utf8_is_valid`. */
+size_t
+utf8_count(String s);
+
+
+/** @brief Decode the codepoint at `*cursor`, then move `*cursor` past it.
+ *  An invalid or truncated sequence decodes as `UTF8_RUNE_ERROR`, and only
+ *  its first byte is skipped.
+ *
+ * @return `false` if there are no bytes left, leaving `*rune` untouched.
+ */
+bool
+utf8_next_rune(String s, size_t *cursor, u32 *rune);
+
+#endif /* UTILS_UTF8_H */